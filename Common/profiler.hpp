@@ -0,0 +1,176 @@
+// Lightweight scoped-zone profiler shared by the projects.
+//
+// Usage:
+//   PROF_ZONE("computeAccelerations");     // times the enclosing scope
+//   prof::setEnabled(true);                // runtime toggle
+//   prof::overlayText();                   // multi-line string for a HUD
+//   prof::dump("app_profile.csv");         // machine-readable dump
+//
+// When disabled (the default), an armed zone costs one relaxed atomic
+// load and nothing else — no clock reads, no locking — so zones can
+// stay compiled into release builds. Defining PROF_DISABLE strips the
+// macro entirely. Each zone keeps a ring of its most recent durations
+// plus lifetime totals, so transient spikes survive long enough to be
+// dumped or drawn even though memory use stays fixed.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace prof {
+
+// Recent samples kept per zone
+const size_t RING_CAPACITY = 256;
+
+struct Zone {
+    const char* name = nullptr;
+    double ring[RING_CAPACITY] = {};   // microseconds, oldest overwritten
+    size_t head = 0;                   // next write position
+    size_t count = 0;                  // valid samples in the ring
+    uint64_t hits = 0;
+    double totalUs = 0.0;
+};
+
+class Profiler {
+public:
+    static Profiler& instance() {
+        static Profiler p;
+        return p;
+    }
+
+    bool enabled() const {
+        return on.load(std::memory_order_relaxed);
+    }
+
+    void setEnabled(bool e) {
+        on.store(e, std::memory_order_relaxed);
+    }
+
+    // Called once per call site via a function-local static
+    int registerZone(const char* name) {
+        std::lock_guard<std::mutex> lock(mtx);
+        zones.push_back(Zone{});
+        zones.back().name = name;
+        return (int)zones.size() - 1;
+    }
+
+    void record(int zone, double us) {
+        std::lock_guard<std::mutex> lock(mtx);
+        Zone& z = zones[zone];
+        z.ring[z.head] = us;
+        z.head = (z.head + 1) % RING_CAPACITY;
+        if (z.count < RING_CAPACITY) z.count++;
+        z.hits++;
+        z.totalUs += us;
+    }
+
+    // One line per zone: average over all hits and worst of the ring.
+    // Suitable for drawing as an on-screen overlay.
+    std::string overlayText() const {
+        std::lock_guard<std::mutex> lock(mtx);
+        std::string out;
+        char line[160];
+        for (const Zone& z : zones) {
+            if (z.hits == 0) continue;
+            double worst = 0.0;
+            for (size_t i = 0; i < z.count; i++)
+                if (z.ring[i] > worst) worst = z.ring[i];
+            snprintf(line, sizeof(line), "%-28s avg %8.1f us  max %8.1f us\n",
+                z.name, z.totalUs / (double)z.hits, worst);
+            out += line;
+        }
+        return out;
+    }
+
+    // CSV dump: per-zone lifetime summaries followed by the ring
+    // contents (oldest sample first)
+    bool dump(const std::string& path) const {
+        std::lock_guard<std::mutex> lock(mtx);
+        FILE* f = fopen(path.c_str(), "w");
+        if (!f) return false;
+
+        fprintf(f, "# zone summaries\n");
+        fprintf(f, "zone,hits,total_us,avg_us\n");
+        for (const Zone& z : zones) {
+            if (z.hits == 0) continue;
+            fprintf(f, "%s,%llu,%.1f,%.2f\n", z.name,
+                (unsigned long long)z.hits, z.totalUs,
+                z.totalUs / (double)z.hits);
+        }
+
+        fprintf(f, "# recent samples\n");
+        fprintf(f, "zone,sample,us\n");
+        for (const Zone& z : zones) {
+            size_t start = (z.head + RING_CAPACITY - z.count) % RING_CAPACITY;
+            for (size_t i = 0; i < z.count; i++) {
+                fprintf(f, "%s,%zu,%.2f\n", z.name, i,
+                    z.ring[(start + i) % RING_CAPACITY]);
+            }
+        }
+
+        fclose(f);
+        return true;
+    }
+
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+
+private:
+    Profiler() = default;
+
+    std::atomic<bool> on{ false };
+    mutable std::mutex mtx;
+    std::vector<Zone> zones;
+};
+
+inline bool enabled() { return Profiler::instance().enabled(); }
+inline void setEnabled(bool e) { Profiler::instance().setEnabled(e); }
+inline std::string overlayText() { return Profiler::instance().overlayText(); }
+inline bool dump(const std::string& path) { return Profiler::instance().dump(path); }
+
+// Times the enclosing scope when profiling is enabled; the disabled
+// path is a single relaxed load
+class ScopedZone {
+public:
+    explicit ScopedZone(int zone) : zone(zone) {
+        if (Profiler::instance().enabled()) {
+            armed = true;
+            start = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~ScopedZone() {
+        if (!armed) return;
+        auto end = std::chrono::steady_clock::now();
+        double us = std::chrono::duration<double, std::micro>(end - start).count();
+        Profiler::instance().record(zone, us);
+    }
+
+    ScopedZone(const ScopedZone&) = delete;
+    ScopedZone& operator=(const ScopedZone&) = delete;
+
+private:
+    int zone;
+    bool armed = false;
+    std::chrono::steady_clock::time_point start;
+};
+
+} // namespace prof
+
+#if defined(PROF_DISABLE)
+#define PROF_ZONE(name)
+#else
+#define PROF_CONCAT2(a, b) a##b
+#define PROF_CONCAT(a, b) PROF_CONCAT2(a, b)
+#define PROF_ZONE(name) \
+    static const int PROF_CONCAT(profZoneId_, __LINE__) = \
+        prof::Profiler::instance().registerZone(name); \
+    prof::ScopedZone PROF_CONCAT(profZone_, __LINE__)( \
+        PROF_CONCAT(profZoneId_, __LINE__))
+#endif
@@ -0,0 +1,331 @@
+// Scenario loader shared by the projects.
+//
+// One text schema covers all four worlds: gravitating bodies for the
+// orbital sim, arena settings for Munch, ecosystem seeds for FloraFauna,
+// and economy constants for HOARD. Each program reads only its own
+// fields and keeps its built-in defaults for anything the file leaves
+// unset, so a single scenario can drive any subset of the programs and
+// a sweep harness can launch variants without recompiling.
+//
+// Usage:
+//   scn::Scenario s;
+//   std::string err;
+//   if (!scn::load("sweep.scn", s, err)) { /* report err, bail */ }
+//
+// Text format (INI-style, '#' comments):
+//   [nbody]
+//   # body = <mass> <distanceAU> <r> <g> <b> <drawSize>
+//   body = 3.00e-6 1.00 0 0 255 2.0
+//   [munch]
+//   win_width = 1200
+//   [florafauna]
+//   seed = 42
+//   [hoard]
+//   db_url = https://example.test
+//
+// The text is parsed and validated once, then cached as a binary blob
+// next to the source file ("<path>.bin"). Later loads read the blob
+// straight into the struct — no tokenizing, no validation — so a
+// parameterized cold start costs milliseconds. A cache older than the
+// text, or with the wrong magic, version, or length, is ignored and
+// rebuilt from the text; deleting the .bin is always safe.
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <sys/stat.h>
+#include <vector>
+
+namespace scn {
+
+// Blob header; bump the version whenever the layout below changes so
+// stale caches from older binaries reparse instead of misload
+const char CACHE_MAGIC[4] = { 'S', 'C', 'N', '1' };
+const uint32_t CACHE_VERSION = 1;
+
+// One orbiting body for the N-body sim (mass relative to the central
+// body, circular orbit at distanceAU)
+struct Body {
+    double mass = 0.0;
+    double distanceAU = 0.0;
+    float drawSize = 1.f;
+    uint8_t r = 255, g = 255, b = 255;
+};
+
+struct Scenario {
+    // [nbody] — empty means "use the program's built-in system"
+    std::vector<Body> bodies;
+
+    // [munch]
+    uint32_t winWidth = 1200;
+    uint32_t winHeight = 800;
+    int32_t winScore = 100;
+    uint32_t maxParticles = 50;
+    float playerSpeed = 400.f;
+
+    // [florafauna]
+    uint64_t seed = 1;
+    int32_t plants = 10;
+    int32_t herbivores = 0;
+    int32_t carnivores = 0;
+
+    // [hoard] — empty dbUrl means "keep the program's default"
+    std::string dbUrl;
+    int64_t idleUpgradeCost = 5000;
+    int64_t luckUpgradeCost = 8000;
+};
+
+// Modification time, or -1 if the file doesn't exist. st_mtime is all
+// the staleness check needs; sub-second precision would only matter for
+// edits racing the cache write within the same second.
+inline long long mtimeOf(const std::string& path) {
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) return -1;
+    return (long long)st.st_mtime;
+}
+
+// --- binary cache -----------------------------------------------------
+
+inline bool readCache(const std::string& path, Scenario& out) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) return false;
+
+    bool ok = true;
+    auto rd = [&](void* p, size_t n) {
+        if (ok && fread(p, 1, n, f) != n) ok = false;
+    };
+
+    char magic[4];
+    uint32_t version = 0;
+    rd(magic, 4);
+    rd(&version, sizeof version);
+    if (!ok || memcmp(magic, CACHE_MAGIC, 4) != 0 || version != CACHE_VERSION) {
+        fclose(f);
+        return false;
+    }
+
+    Scenario s;
+    rd(&s.winWidth, sizeof s.winWidth);
+    rd(&s.winHeight, sizeof s.winHeight);
+    rd(&s.winScore, sizeof s.winScore);
+    rd(&s.maxParticles, sizeof s.maxParticles);
+    rd(&s.playerSpeed, sizeof s.playerSpeed);
+    rd(&s.seed, sizeof s.seed);
+    rd(&s.plants, sizeof s.plants);
+    rd(&s.herbivores, sizeof s.herbivores);
+    rd(&s.carnivores, sizeof s.carnivores);
+    rd(&s.idleUpgradeCost, sizeof s.idleUpgradeCost);
+    rd(&s.luckUpgradeCost, sizeof s.luckUpgradeCost);
+
+    uint32_t bodyCount = 0;
+    rd(&bodyCount, sizeof bodyCount);
+    if (ok && bodyCount <= 100000) {
+        s.bodies.resize(bodyCount);
+        for (Body& b : s.bodies) {
+            rd(&b.mass, sizeof b.mass);
+            rd(&b.distanceAU, sizeof b.distanceAU);
+            rd(&b.drawSize, sizeof b.drawSize);
+            rd(&b.r, 1); rd(&b.g, 1); rd(&b.b, 1);
+        }
+    }
+    else ok = false;
+
+    uint32_t urlLen = 0;
+    rd(&urlLen, sizeof urlLen);
+    if (ok && urlLen <= 4096) {
+        s.dbUrl.resize(urlLen);
+        if (urlLen) rd(&s.dbUrl[0], urlLen);
+    }
+    else ok = false;
+
+    // The blob must end exactly where the layout says it does; trailing
+    // garbage means a torn or foreign write
+    if (ok && fgetc(f) != EOF) ok = false;
+
+    fclose(f);
+    if (ok) out = s;
+    return ok;
+}
+
+// Best effort: a failed cache write just means the next load reparses
+inline void writeCache(const std::string& path, const Scenario& s) {
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f) return;
+
+    auto wr = [&](const void* p, size_t n) { fwrite(p, 1, n, f); };
+
+    wr(CACHE_MAGIC, 4);
+    wr(&CACHE_VERSION, sizeof CACHE_VERSION);
+
+    wr(&s.winWidth, sizeof s.winWidth);
+    wr(&s.winHeight, sizeof s.winHeight);
+    wr(&s.winScore, sizeof s.winScore);
+    wr(&s.maxParticles, sizeof s.maxParticles);
+    wr(&s.playerSpeed, sizeof s.playerSpeed);
+    wr(&s.seed, sizeof s.seed);
+    wr(&s.plants, sizeof s.plants);
+    wr(&s.herbivores, sizeof s.herbivores);
+    wr(&s.carnivores, sizeof s.carnivores);
+    wr(&s.idleUpgradeCost, sizeof s.idleUpgradeCost);
+    wr(&s.luckUpgradeCost, sizeof s.luckUpgradeCost);
+
+    uint32_t bodyCount = (uint32_t)s.bodies.size();
+    wr(&bodyCount, sizeof bodyCount);
+    for (const Body& b : s.bodies) {
+        wr(&b.mass, sizeof b.mass);
+        wr(&b.distanceAU, sizeof b.distanceAU);
+        wr(&b.drawSize, sizeof b.drawSize);
+        wr(&b.r, 1); wr(&b.g, 1); wr(&b.b, 1);
+    }
+
+    uint32_t urlLen = (uint32_t)s.dbUrl.size();
+    wr(&urlLen, sizeof urlLen);
+    if (urlLen) wr(s.dbUrl.data(), urlLen);
+
+    fclose(f);
+}
+
+// --- text parsing -----------------------------------------------------
+
+inline std::string trim(const std::string& s) {
+    size_t a = s.find_first_not_of(" \t\r");
+    if (a == std::string::npos) return "";
+    size_t b = s.find_last_not_of(" \t\r");
+    return s.substr(a, b - a + 1);
+}
+
+inline bool fail(std::string& err, const std::string& path, int line,
+    const std::string& msg) {
+    err = path + ":" + std::to_string(line) + ": " + msg;
+    return false;
+}
+
+// Validation happens here, once, at parse time; everything the cache
+// hands back later is already known good
+inline bool parseText(const std::string& path, Scenario& out, std::string& err) {
+    std::ifstream in(path);
+    if (!in) {
+        err = "cannot open scenario file: " + path;
+        return false;
+    }
+
+    Scenario s;
+    std::string section, rawLine;
+    int lineNo = 0;
+
+    while (std::getline(in, rawLine)) {
+        lineNo++;
+        std::string line = trim(rawLine);
+        if (line.empty() || line[0] == '#') continue;
+
+        if (line.front() == '[') {
+            if (line.back() != ']')
+                return fail(err, path, lineNo, "malformed section header");
+            section = trim(line.substr(1, line.size() - 2));
+            if (section != "nbody" && section != "munch" &&
+                section != "florafauna" && section != "hoard")
+                return fail(err, path, lineNo, "unknown section [" + section + "]");
+            continue;
+        }
+
+        size_t eq = line.find('=');
+        if (eq == std::string::npos)
+            return fail(err, path, lineNo, "expected key = value");
+        std::string key = trim(line.substr(0, eq));
+        std::string value = trim(line.substr(eq + 1));
+        if (section.empty())
+            return fail(err, path, lineNo, "key before any [section]");
+        if (value.empty())
+            return fail(err, path, lineNo, "empty value for " + key);
+
+        std::istringstream vs(value);
+
+        if (section == "nbody") {
+            if (key != "body")
+                return fail(err, path, lineNo, "unknown key " + key);
+            Body b;
+            int r, g, bl;
+            if (!(vs >> b.mass >> b.distanceAU >> r >> g >> bl >> b.drawSize))
+                return fail(err, path, lineNo,
+                    "body needs: mass distanceAU r g b drawSize");
+            if (b.mass <= 0.0 || b.distanceAU <= 0.0 || b.drawSize <= 0.f)
+                return fail(err, path, lineNo,
+                    "body mass, distance and size must be positive");
+            if (r < 0 || r > 255 || g < 0 || g > 255 || bl < 0 || bl > 255)
+                return fail(err, path, lineNo, "body color must be 0-255");
+            b.r = (uint8_t)r; b.g = (uint8_t)g; b.b = (uint8_t)bl;
+            s.bodies.push_back(b);
+        }
+        else if (section == "munch") {
+            long long n = strtoll(value.c_str(), nullptr, 10);
+            if (key == "win_width") s.winWidth = (uint32_t)n;
+            else if (key == "win_height") s.winHeight = (uint32_t)n;
+            else if (key == "win_score") s.winScore = (int32_t)n;
+            else if (key == "max_particles") s.maxParticles = (uint32_t)n;
+            else if (key == "player_speed") s.playerSpeed = strtof(value.c_str(), nullptr);
+            else return fail(err, path, lineNo, "unknown key " + key);
+        }
+        else if (section == "florafauna") {
+            long long n = strtoll(value.c_str(), nullptr, 10);
+            if (key == "seed") s.seed = strtoull(value.c_str(), nullptr, 10);
+            else if (key == "plants") s.plants = (int32_t)n;
+            else if (key == "herbivores") s.herbivores = (int32_t)n;
+            else if (key == "carnivores") s.carnivores = (int32_t)n;
+            else return fail(err, path, lineNo, "unknown key " + key);
+        }
+        else { // hoard
+            if (key == "db_url") s.dbUrl = value;
+            else if (key == "idle_upgrade_cost")
+                s.idleUpgradeCost = strtoll(value.c_str(), nullptr, 10);
+            else if (key == "luck_upgrade_cost")
+                s.luckUpgradeCost = strtoll(value.c_str(), nullptr, 10);
+            else return fail(err, path, lineNo, "unknown key " + key);
+        }
+    }
+
+    // Range checks that span keys
+    if (s.winWidth < 320 || s.winWidth > 7680 ||
+        s.winHeight < 240 || s.winHeight > 4320)
+        return fail(err, path, 0, "window size out of range (320x240..7680x4320)");
+    if (s.winScore < 1)
+        return fail(err, path, 0, "win_score must be at least 1");
+    if (s.maxParticles < 1 || s.maxParticles > 1000000)
+        return fail(err, path, 0, "max_particles out of range (1..1000000)");
+    if (s.playerSpeed <= 0.f)
+        return fail(err, path, 0, "player_speed must be positive");
+    if (s.plants < 0 || s.herbivores < 0 || s.carnivores < 0 ||
+        s.plants > 1000000 || s.herbivores > 1000000 || s.carnivores > 1000000)
+        return fail(err, path, 0, "population seeds out of range (0..1000000)");
+    if (s.idleUpgradeCost < 1 || s.luckUpgradeCost < 1)
+        return fail(err, path, 0, "upgrade costs must be at least 1");
+
+    out = s;
+    return true;
+}
+
+// Load a scenario, preferring the binary cache ("<path>.bin") when it
+// is at least as new as the text. On a cache miss the text is parsed,
+// validated, and the cache rewritten for next time.
+inline bool load(const std::string& path, Scenario& out, std::string& err) {
+    long long srcTime = mtimeOf(path);
+    if (srcTime < 0) {
+        err = "cannot open scenario file: " + path;
+        return false;
+    }
+
+    std::string cachePath = path + ".bin";
+    if (mtimeOf(cachePath) >= srcTime && readCache(cachePath, out))
+        return true;
+
+    if (!parseText(path, out, err)) return false;
+    writeCache(cachePath, out);
+    return true;
+}
+
+} // namespace scn
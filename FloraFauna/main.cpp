@@ -1,357 +1,1054 @@
 #include <iostream>
 #include <vector>
-#include <random>
 #include <chrono>
 #include <string>
-#include <unordered_set>
 #include <thread>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <mutex>
+
+#include "../Common/profiler.hpp"
+#include "../Common/scenario.hpp"
 
 using namespace std;
 
-unordered_set<int> usedIDs;
-
-double random01() {
-    static std::mt19937 rng(
-        std::chrono::steady_clock::now().time_since_epoch().count()
-    );
-    static std::uniform_real_distribution<double> dist(0.0, 1.0);
-    return dist(rng);
-}
-
-int generateUniqueID() {
-    static std::mt19937 rng(
-        std::chrono::steady_clock::now().time_since_epoch().count()
-    );
-    static std::uniform_int_distribution<int> dist(100000, 999999);
-
-    int id;
-    do {
-        id = dist(rng);
-    } while (usedIDs.find(id) != usedIDs.end());
-
-    usedIDs.insert(id);
-    return id;
+// splitmix64 finalizer: the bijective mixer underneath CounterRng
+uint64_t mix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
 }
 
-class Entity {
-protected:
-    int id;
-    bool isAlive;
-    int age;
-    int energy;
-
+// Counter-based RNG in the philox/threefry mold: each draw is a
+// stateless mix of (key, counter), where the key folds in
+// (seed, day, phase, entityID). Every entity gets its own independent,
+// exactly reproducible stream — no shared generator state, nothing to
+// serialize across threads, and results don't depend on iteration or
+// chunking order.
+class CounterRng {
 public:
-    Entity() {
-        id = generateUniqueID();
-        isAlive = true;
-        age = 0;
-        energy = 10;
+    CounterRng(uint64_t seed, uint64_t day, uint64_t phase, uint64_t entityID) {
+        uint64_t k = mix64(seed ^ (day * 0x9E3779B97F4A7C15ULL));
+        k = mix64(k ^ (phase * 0xBF58476D1CE4E5B9ULL));
+        key = mix64(k ^ entityID);
     }
 
-    void ageUp() {
-        age++;
+    // Uniform double in [0, 1): top 53 bits of the mixed counter
+    double next01() {
+        uint64_t bits = mix64(key ^ (counter++ * 0x94D049BB133111EBULL));
+        return (bits >> 11) * (1.0 / 9007199254740992.0);
     }
 
-    void die() {
-        isAlive = false;
-    }
+private:
+    uint64_t key;
+    uint64_t counter = 0;
+};
 
-    bool alive() const {
-        return isAlive;
-    }
+enum EntityKind { KIND_PLANT, KIND_ANIMAL, KIND_CARNIVORE };
 
-    int getEnergy() const {
-        return energy;
-    }
+// Weather is rolled once per step and carried as an enum; the hot
+// loops index these tables instead of comparing strings per entity.
+// Values match the old string-compare branches exactly.
+enum Weather { WEATHER_CLEAR = 0, WEATHER_RAIN = 1, WEATHER_DROUGHT = 2 };
+
+struct WeatherParams {
+    double plantGrowthChance;
+    int photosynthesisBoost;
+    int herbivoreDrain;
+    int carnivoreDrain;
+};
+
+constexpr WeatherParams WEATHER_TABLE[3] = {
+    { 0.3, 3, 2, 3 },  // Clear
+    { 0.5, 1, 1, 3 },  // Rain
+    { 0.1, 0, 3, 4 },  // Drought
+};
+
+constexpr const char* WEATHER_NAMES[3] = { "Clear", "Rain", "Drought" };
 
-    int getID() const {
-        return id;
+// Handle-based entity directory. An ID packs a directory slot in the
+// low 32 bits and that slot's generation in the high 32 bits; slots
+// are recycled through a free list with the generation bumped, so a
+// stale ID from a dead entity can never resolve to its slot's new
+// occupant. allocate() and release() are O(1) — replacing the old
+// rejection-sampling loop against a global usedIDs set — and lookup
+// by ID is a bounds check plus a generation compare.
+class EntityDirectory {
+public:
+    long long allocate(int kind, size_t index) {
+        uint32_t slot;
+        vector<uint32_t>& free = freeSlots[kind];
+        if (!free.empty()) {
+            slot = free.back();
+            free.pop_back();
+        } else {
+            slot = (uint32_t)slots.size();
+            slots.push_back({ 1, 0, 0 });
+        }
+        slots[slot].kind = (uint32_t)kind;
+        slots[slot].index = (uint32_t)index;
+        return ((long long)slots[slot].generation << 32) | slot;
     }
 
-    void addEnergy(int e) {
-        energy += e;
+    void release(long long id) {
+        uint32_t slot = (uint32_t)id;
+        slots[slot].generation++;
+        freeSlots[slots[slot].kind].push_back(slot);
     }
 
-    void reduceEnergy(int e) {
-        energy -= e;
-        if (energy <= 0) die();
+    // Keeps the directory current when compaction swap-and-pops an
+    // entity to a new index
+    void moveEntity(long long id, size_t newIndex) {
+        slots[(uint32_t)id].index = (uint32_t)newIndex;
     }
 
-    virtual void displayInfo() {
-        cout << "ID: " << id << endl;
-        cout << "Alive: " << (isAlive ? "Yes" : "No") << endl;
-        cout << "Age: " << age << endl;
-        cout << "Energy: " << energy << endl;
+    bool lookup(long long id, int& kind, size_t& index) const {
+        uint32_t slot = (uint32_t)id;
+        uint32_t generation = (uint32_t)((uint64_t)id >> 32);
+        if (slot >= slots.size() || slots[slot].generation != generation)
+            return false;
+        kind = (int)slots[slot].kind;
+        index = slots[slot].index;
+        return true;
     }
-};
 
-class Plant : public Entity {
 private:
-    string type;
-    int growthStage;
+    struct Slot {
+        uint32_t generation;
+        uint32_t kind;
+        uint32_t index;
+    };
+
+    vector<Slot> slots;
+    // One free list per kind, so the three concurrent compaction
+    // passes each release into their own list — a single shared list
+    // would race, and even a locked one would recycle slots in
+    // scheduling order, feeding nondeterministic IDs into the
+    // per-entity RNG keys. Per-slot fields are only ever written by
+    // the population that owns the slot's entity, and the slots
+    // vector itself only grows during the serial spawn phases.
+    vector<uint32_t> freeSlots[3];
+};
 
+// Persistent worker pool for the parallel step phases. Workers pull
+// fixed-size chunks off a shared cursor; the calling thread joins in
+// rather than blocking idle. Chunk boundaries are the same no matter
+// how many threads run or which thread grabs which chunk, which is
+// what keeps parallel runs reproducible.
+class ThreadPool {
 public:
-    Plant(string t) : Entity() {
-        type = t;
-        growthStage = 0;
+    static ThreadPool& instance() {
+        static ThreadPool pool;
+        return pool;
     }
 
-    void grow(vector<Plant>& newPlants, int plantCount, string weather) {
-        double growthChance = 0.3;
-        if (weather == "Rain") growthChance = 0.5;
-        if (weather == "Drought") growthChance = 0.1;
-
-        if (isAlive && random01() < growthChance) growthStage++;
+    // Runs fn(begin, end) over [0, count) in aligned chunks of `chunk`
+    void run(size_t count, size_t chunk,
+        const function<void(size_t, size_t)>& fn) {
+        if (count == 0) return;
+        if (workers.empty()) {
+            for (size_t b = 0; b < count; b += chunk)
+                fn(b, min(b + chunk, count));
+            return;
+        }
 
-        if (growthStage > 5) {
-            if (random01() < 0.01) die();
-            else growthStage = 5;
+        {
+            lock_guard<mutex> lock(mtx);
+            job = &fn;
+            jobCount = count;
+            jobChunk = max<size_t>(1, chunk);
+            cursor.store(0, memory_order_relaxed);
+            pending = workers.size();
+            ++generation;
         }
+        wakeCv.notify_all();
 
-        double capFactor = 1.0 - (plantCount / 300.0);
-        if (capFactor < 0) capFactor = 0;
+        drain();
 
-        if (growthStage == 5 && random01() < (0.25 * capFactor)) {
-            newPlants.push_back(Plant(type));
-        }
+        unique_lock<mutex> lock(mtx);
+        doneCv.wait(lock, [this] { return pending == 0; });
+        job = nullptr;
     }
 
-    void photosynthesize(string weather) {
-        if (!isAlive) return;
-        
-        int boost = 2;
-        if (weather == "Clear") boost = 3;
-        if (weather == "Rain") boost = 1;
-        if (weather == "Drought") boost = 0;
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
 
-        energy += boost;
-        if (energy > 30) energy = 30;
+private:
+    ThreadPool() {
+        unsigned hw = thread::hardware_concurrency();
+        size_t extra = hw > 1 ? hw - 1 : 0;
+        for (size_t t = 0; t < extra; ++t)
+            workers.emplace_back([this] { workerLoop(); });
     }
 
-    int beEaten(int amount) {
-        if (!isAlive) return 0;
-        int available = energy - 1; 
-        if (available <= 0) return 0;
+    ~ThreadPool() {
+        {
+            lock_guard<mutex> lock(mtx);
+            stopping = true;
+        }
+        wakeCv.notify_all();
+        for (auto& w : workers)
+            w.join();
+    }
 
-        int consumed = min(available, amount);
-        energy -= consumed;
-        return consumed;
+    void drain() {
+        const auto* fn = job;
+        while (true) {
+            size_t begin = cursor.fetch_add(jobChunk, memory_order_relaxed);
+            if (begin >= jobCount)
+                break;
+            (*fn)(begin, min(begin + jobChunk, jobCount));
+        }
     }
 
-    void displayInfo() {
-        Entity::displayInfo();
-        cout << "Type: " << type << endl;
-        cout << "Growth Stage: " << growthStage << endl;
+    void workerLoop() {
+        size_t seen = 0;
+        while (true) {
+            {
+                unique_lock<mutex> lock(mtx);
+                wakeCv.wait(lock, [&] { return stopping || generation != seen; });
+                if (stopping)
+                    return;
+                seen = generation;
+            }
+
+            drain();
+
+            {
+                lock_guard<mutex> lock(mtx);
+                if (--pending == 0)
+                    doneCv.notify_one();
+            }
+        }
     }
+
+    vector<thread> workers;
+    mutex mtx;
+    condition_variable wakeCv, doneCv;
+    const function<void(size_t, size_t)>* job = nullptr;
+    size_t jobCount = 0, jobChunk = 1;
+    atomic<size_t> cursor{ 0 };
+    size_t pending = 0, generation = 0;
+    bool stopping = false;
 };
 
-class Animal : public Entity {
-private:
-    string species;
+// World geometry: entities live on a square [0, WORLD_SIZE) field.
+// CELL_SIZE doubles as the forage/hunt radius, so a 3x3 cell
+// neighborhood always covers an interaction circle.
+constexpr float WORLD_SIZE = 100.f;
+constexpr float CELL_SIZE = 5.f;
+const float GRAZE_RADIUS = 5.f;
+const float HUNT_RADIUS = 5.f;
+const float WANDER_STEP = 2.f;   // max per-day animal movement per axis
+const float BIRTH_SPREAD = 3.f;  // offspring scatter around the parent
+
+float clampPos(float v) {
+    if (v < 0.f) return 0.f;
+    if (v >= WORLD_SIZE) return WORLD_SIZE - 0.001f;
+    return v;
+}
 
+// Flat counting-sort spatial grid, rebuilt in O(n) before each phase
+// that queries it. cellStart is a prefix sum over per-cell counts and
+// entries holds entity indices grouped by cell, so a neighborhood
+// query walks a few short contiguous runs instead of scattering random
+// probes across the whole population.
+class SpatialGrid {
 public:
-    Animal(string sp) : Entity() {
-        species = sp;
-    }
-
-    void act(vector<Plant>& plants, vector<Animal>& newAnimals, int animalCount, string weather) {
-        if (!isAlive) return;
+    void build(const vector<float>& xs, const vector<float>& ys) {
+        size_t n = xs.size();
+        cellStart.assign((size_t)COLS * COLS + 1, 0);
+        cellOfEntity.resize(n);
+        entries.resize(n);
+
+        for (size_t i = 0; i < n; i++) {
+            int cell = cellOf(xs[i], ys[i]);
+            cellOfEntity[i] = cell;
+            cellStart[cell + 1]++;
+        }
+        for (size_t c = 1; c < cellStart.size(); c++) {
+            cellStart[c] += cellStart[c - 1];
+        }
 
-        if (!plants.empty()) {
-            int bestIndex = -1;
-            int bestEnergy = -1;
+        cursor.assign(cellStart.begin(), cellStart.end() - 1);
+        for (size_t i = 0; i < n; i++) {
+            entries[cursor[cellOfEntity[i]]++] = (int)i;
+        }
+    }
 
-            for (int i = 0; i < 5; i++) {
-                int idx = (int)(random01() * plants.size());
-                if (plants[idx].getEnergy() > bestEnergy) {
-                    bestEnergy = plants[idx].getEnergy();
-                    bestIndex = idx;
+    // Visits every entity index in the 3x3 cell neighborhood of (x, y)
+    template <typename Visitor>
+    void forEachNear(float x, float y, Visitor&& visit) const {
+        int cx = (int)(x / CELL_SIZE);
+        int cy = (int)(y / CELL_SIZE);
+
+        for (int gy = max(0, cy - 1); gy <= min(COLS - 1, cy + 1); gy++) {
+            for (int gx = max(0, cx - 1); gx <= min(COLS - 1, cx + 1); gx++) {
+                size_t c = (size_t)gy * COLS + gx;
+                for (int e = cellStart[c]; e < cellStart[c + 1]; e++) {
+                    visit(entries[e]);
                 }
             }
-
-            if (bestIndex != -1) {
-                int gained = plants[bestIndex].beEaten(5);
-                energy += gained;
-            }
         }
+    }
 
-        int drain = 2;
-        if (weather == "Drought") drain = 3;
-        if (weather == "Rain") drain = 1;
-        reduceEnergy(drain);
+private:
+    static const int COLS = (int)(WORLD_SIZE / CELL_SIZE);
 
-        double base = 0.05;
-        double K = 300.0;
-        double factor = 1.0 - (animalCount / K);
-        if (factor < 0) factor = 0;
+    int cellOf(float x, float y) const {
+        int cx = min(COLS - 1, max(0, (int)(x / CELL_SIZE)));
+        int cy = min(COLS - 1, max(0, (int)(y / CELL_SIZE)));
+        return cy * COLS + cx;
+    }
 
-        double reproductionChance = base * factor;
-
-        if (energy >= 20 && random01() < reproductionChance) {
-            if (random01() < 0.25 && energy >= 40) {
-                Animal c1(species);
-                Animal c2(species);
-                newAnimals.push_back(c1);
-                newAnimals.push_back(c2);
-                energy -= 30;
-            } else {
-                Animal child(species);
-                newAnimals.push_back(child);
-                energy -= 15;
-            }
-        }
+    vector<int> cellStart;
+    vector<int> cellOfEntity;
+    vector<int> entries;
+    vector<int> cursor;
+};
 
-        if (age > 30 && random01() < 0.1) die();
+// Species names are stored once here and referenced everywhere else by
+// small integer handles, so the per-entity storage carries no strings.
+// The intern list stays tiny (a handful of species), so a linear scan
+// on intern() is fine.
+class SpeciesTable {
+public:
+    int intern(const string& name) {
+        for (int i = 0; i < (int)names.size(); i++) {
+            if (names[i] == name) return i;
+        }
+        names.push_back(name);
+        return (int)names.size() - 1;
     }
 
-    void displayInfo() {
-        Entity::displayInfo();
-        cout << "Species: " << species << " (Herbivore)" << endl;
+    const string& name(int handle) const {
+        return names[handle];
     }
-};
 
-class Carnivore : public Entity {
 private:
-    string species;
+    vector<string> names;
+};
 
-public:
-    Carnivore(string sp) : Entity() {
-        species = sp;
-        energy = 30;
+// A staged birth: the species handle plus where the offspring lands
+// (scattered around its parent)
+struct Birth {
+    int species;
+    float x, y;
+};
+
+// A staged hunt: which carnivore wants which prey. Emitted during the
+// scan pass and applied later in carnivore order.
+struct HuntIntent {
+    uint32_t carnivore;
+    uint32_t prey;
+};
+
+// Struct-of-arrays entity storage: element i of every array describes
+// entity i. step() walks contiguous int arrays instead of objects that
+// each drag a vtable pointer and a heap-allocated string through the
+// cache — the virtual displayInfo() was only ever used by the inspect
+// menu, which now reconstructs names from the species table instead.
+struct Population {
+    vector<long long> id;
+    vector<char> alive;
+    vector<int> age;
+    vector<int> energy;
+    vector<int> species;
+    vector<float> posX;
+    vector<float> posY;
+
+    EntityDirectory* directory = nullptr;
+    int kind = KIND_PLANT;
+
+    void attach(EntityDirectory* dir, int k) {
+        directory = dir;
+        kind = k;
+    }
+
+    size_t size() const {
+        return id.size();
     }
 
-    void act(vector<Animal>& prey, vector<Carnivore>& newCarnivores, int carnCount, string weather) {
-        if (!isAlive) return;
+    void spawn(int speciesHandle, int startEnergy, float x, float y) {
+        reserveFor(id.size() + 1);
+        id.push_back(directory->allocate(kind, id.size()));
+        alive.push_back(1);
+        age.push_back(0);
+        energy.push_back(startEnergy);
+        species.push_back(speciesHandle);
+        posX.push_back(x);
+        posY.push_back(y);
+    }
 
-        if (!prey.empty() && energy < 40) {
-            int targetIndex = (int)(random01() * prey.size());
-            if (prey[targetIndex].alive()) {
-                prey[targetIndex].die();
-                energy += 25;
-            }
+    // Bulk splice of a whole staging buffer: one capacity check, then
+    // the constant-valued arrays append as single inserts
+    void spawnMany(const vector<Birth>& births, int startEnergy) {
+        size_t base = id.size();
+        size_t n = births.size();
+        if (n == 0) return;
+
+        reserveFor(base + n);
+        alive.insert(alive.end(), n, 1);
+        age.insert(age.end(), n, 0);
+        energy.insert(energy.end(), n, startEnergy);
+        for (size_t k = 0; k < n; k++) {
+            id.push_back(directory->allocate(kind, base + k));
+            species.push_back(births[k].species);
+            posX.push_back(births[k].x);
+            posY.push_back(births[k].y);
         }
+    }
 
-        int drain = 3;
-        if (weather == "Drought") drain = 4;
-        reduceEnergy(drain);
+    // Growth policy: overshoot demand by 50% so a population growing
+    // at a steady birth rate settles into zero reallocations per step
+    void reserveFor(size_t needed) {
+        if (needed <= id.capacity()) return;
+        size_t target = needed + needed / 2;
+        id.reserve(target);
+        alive.reserve(target);
+        age.reserve(target);
+        energy.reserve(target);
+        species.reserve(target);
+        posX.reserve(target);
+        posY.reserve(target);
+    }
 
-        double base = 0.02;
-        double K = 50.0;
-        double factor = 1.0 - (carnCount / K);
-        if (factor < 0) factor = 0;
+    void kill(size_t i) {
+        alive[i] = 0;
+    }
 
-        if (energy >= 50 && random01() < (base * factor)) {
-            Carnivore child(species);
-            newCarnivores.push_back(child);
-            energy -= 25;
-        }
+    void reduceEnergy(size_t i, int e) {
+        energy[i] -= e;
+        if (energy[i] <= 0) alive[i] = 0;
+    }
+
+    // Swap-and-pop across every array; caller re-checks index i. The
+    // removed entity's directory slot is released and the swapped-in
+    // entity's index is patched.
+    void removeAt(size_t i) {
+        directory->release(id[i]);
+        id[i] = id.back();           id.pop_back();
+        alive[i] = alive.back();     alive.pop_back();
+        age[i] = age.back();         age.pop_back();
+        energy[i] = energy.back();   energy.pop_back();
+        species[i] = species.back(); species.pop_back();
+        posX[i] = posX.back();       posX.pop_back();
+        posY[i] = posY.back();       posY.pop_back();
+        if (i < id.size()) directory->moveEntity(id[i], i);
+    }
+};
 
-        if (age > 40 && random01() < 0.1) die();
+// Plants additionally track a growth stage
+struct PlantStore : Population {
+    vector<int> growthStage;
+
+    void spawn(int speciesHandle, int startEnergy, float x, float y) {
+        growthStage.push_back(0);
+        Population::spawn(speciesHandle, startEnergy, x, y);
+    }
+
+    void spawnMany(const vector<Birth>& births, int startEnergy) {
+        growthStage.insert(growthStage.end(), births.size(), 0);
+        Population::spawnMany(births, startEnergy);
     }
 
-    void displayInfo() {
-        Entity::displayInfo();
-        cout << "Species: " << species << " (Carnivore)" << endl;
+    void reserveFor(size_t needed) {
+        if (needed > growthStage.capacity())
+            growthStage.reserve(needed + needed / 2);
+        Population::reserveFor(needed);
+    }
+
+    void removeAt(size_t i) {
+        growthStage[i] = growthStage.back();
+        growthStage.pop_back();
+        Population::removeAt(i);
     }
 };
 
 class World {
 public:
-    vector<Plant> plants;
-    vector<Animal> animals;
-    vector<Carnivore> carnivores;
+    SpeciesTable speciesNames;
+    EntityDirectory directory;
+    PlantStore plants;
+    Population animals;
+    Population carnivores;
     int day = 0;
-    string weather = "Clear";
+    Weather weather = WEATHER_CLEAR;
 
-    void step() {
-        day++;
+    World() {
+        plants.attach(&directory, KIND_PLANT);
+        animals.attach(&directory, KIND_ANIMAL);
+        carnivores.attach(&directory, KIND_CARNIVORE);
+    }
 
-        double wChance = random01();
-        if (wChance < 0.2) weather = "Rain";
-        else if (wChance < 0.4) weather = "Drought";
-        else weather = "Clear";
+    // All step randomness derives from this seed plus (day, phase,
+    // chunk), so a run is exactly reproducible from the seed alone
+    uint64_t seed = 1;
 
-        vector<Plant> newPlants;
-        for (int i = 0; i < plants.size(); i++) {
-            plants[i].grow(newPlants, plants.size(), weather);
-            plants[i].photosynthesize(weather);
-        }
-        for (int i = 0; i < newPlants.size(); i++) {
-            plants.push_back(newPlants[i]);
-        }
+    // Entry points for the menu and initial seeding: placement uses a
+    // seed-derived generator so starting layouts are reproducible too
+    void addPlant(int species) {
+        plants.spawn(species, 10, randomPos(), randomPos());
+    }
 
-        vector<Animal> newAnimals;
-        for (int i = 0; i < animals.size(); i++) {
-            animals[i].ageUp();
-            animals[i].act(plants, newAnimals, animals.size(), weather);
-        }
-        for (int i = 0; i < newAnimals.size(); i++) {
-            animals.push_back(newAnimals[i]);
-        }
+    void addAnimal(int species) {
+        animals.spawn(species, 10, randomPos(), randomPos());
+    }
 
-        vector<Carnivore> newCarnivores;
-        for (int i = 0; i < carnivores.size(); i++) {
-            carnivores[i].ageUp();
-            carnivores[i].act(animals, newCarnivores, carnivores.size(), weather);
-        }
-        for (int i = 0; i < newCarnivores.size(); i++) {
-            carnivores.push_back(newCarnivores[i]);
-        }
+    void addCarnivore(int species) {
+        carnivores.spawn(species, 30, randomPos(), randomPos());
+    }
 
-        for (int i = 0; i < plants.size(); ) {
-            if (!plants[i].alive()) {
-                plants[i] = plants.back();
-                plants.pop_back();
-            } else {
-                i++;
-            }
-        }
+    void step() {
+        PROF_ZONE("World::step");
+        day++;
 
-        for (int i = 0; i < animals.size(); ) {
-            if (!animals[i].alive()) {
-                animals[i] = animals.back();
-                animals.pop_back();
-            } else {
-                i++;
-            }
-        }
+        CounterRng wRng(seed, day, PHASE_WEATHER, 0);
+        double wChance = wRng.next01();
+        if (wChance < 0.2) weather = WEATHER_RAIN;
+        else if (wChance < 0.4) weather = WEATHER_DROUGHT;
+        else weather = WEATHER_CLEAR;
+
+        plantPhase();
+        animalPhase();
+        carnivorePhase();
+
+        // The three compaction passes touch disjoint population
+        // arrays and release into per-kind directory free lists,
+        // so they share no mutable state
+        PROF_ZONE("step.compact");
+        ThreadPool::instance().run(3, 1, [this](size_t which, size_t) {
+            if (which == 0) compact(plants);
+            else if (which == 1) compact(animals);
+            else compact(carnivores);
+        });
+    }
 
-        for (int i = 0; i < carnivores.size(); ) {
-            if (!carnivores[i].alive()) {
-                carnivores[i] = carnivores.back();
-                carnivores.pop_back();
-            } else {
-                i++;
-            }
-        }
+    // Compact weather encoding for the binary stats log (matches the
+    // Weather enum values)
+    uint32_t weatherCode() const {
+        return (uint32_t)weather;
     }
 
     int totalEnergy() {
         int sum = 0;
-        for (int i = 0; i < plants.size(); i++) sum += plants[i].getEnergy();
-        for (int i = 0; i < animals.size(); i++) sum += animals[i].getEnergy();
-        for (int i = 0; i < carnivores.size(); i++) sum += carnivores[i].getEnergy();
+        for (size_t i = 0; i < plants.size(); i++) sum += plants.energy[i];
+        for (size_t i = 0; i < animals.size(); i++) sum += animals.energy[i];
+        for (size_t i = 0; i < carnivores.size(); i++) sum += carnivores.energy[i];
         return sum;
     }
 
     void displayStats() {
         cout << "\n============================\n";
         cout << "Day: " << day << endl;
-        cout << "Weather: " << weather << endl;
+        cout << "Weather: " << WEATHER_NAMES[weather] << endl;
         cout << "Plants: " << plants.size() << endl;
         cout << "Herbivores: " << animals.size() << endl;
         cout << "Carnivores: " << carnivores.size() << endl;
         cout << "Total Energy: " << totalEnergy() << endl;
         cout << "============================\n";
     }
+
+    // Inspect-menu display: reconstructs names from the intern table
+    void displayPlant(size_t i) {
+        displayCommon(plants, i);
+        cout << "Type: " << speciesNames.name(plants.species[i]) << endl;
+        cout << "Growth Stage: " << plants.growthStage[i] << endl;
+    }
+
+    void displayAnimal(size_t i) {
+        displayCommon(animals, i);
+        cout << "Species: " << speciesNames.name(animals.species[i])
+             << " (Herbivore)" << endl;
+    }
+
+    void displayCarnivore(size_t i) {
+        displayCommon(carnivores, i);
+        cout << "Species: " << speciesNames.name(carnivores.species[i])
+             << " (Carnivore)" << endl;
+    }
+
+    // Constant-time inspect: the directory resolves an ID straight to
+    // (population, index), no scanning
+    bool inspectByID(long long entityID) {
+        int kind;
+        size_t index;
+        if (!directory.lookup(entityID, kind, index)) return false;
+
+        if (kind == KIND_PLANT) displayPlant(index);
+        else if (kind == KIND_ANIMAL) displayAnimal(index);
+        else displayCarnivore(index);
+        return true;
+    }
+
+private:
+    // Entities per worker chunk
+    static const size_t CHUNK = 1024;
+
+    enum { PHASE_WEATHER, PHASE_PLANTS, PHASE_ANIMALS, PHASE_CARNIVORES,
+        PHASE_CARNIVORES_POST, PHASE_PLACEMENT };
+
+    // Placement draws sit outside the day loop, so they key on a
+    // monotonic counter instead of (day, entityID)
+    uint64_t placeCounter = 0;
+
+    float randomPos() {
+        CounterRng rng(seed, 0, PHASE_PLACEMENT, placeCounter++);
+        return (float)(rng.next01() * WORLD_SIZE);
+    }
+
+    // Offspring land near the parent, clamped to the field
+    static float scatter(float parent, double roll) {
+        return clampPos(parent + (float)(roll * 2.0 - 1.0) * BIRTH_SPREAD);
+    }
+
+    SpatialGrid plantGrid;
+    SpatialGrid animalGrid;
+
+    // Newborn staging pools reused across steps: cleared each day but
+    // never deallocated, so steady-state steps stage births without
+    // touching the allocator
+    vector<vector<Birth>> plantBirths;
+    vector<Birth> animalBirths;
+    vector<vector<Birth>> carnivoreBirths;
+    vector<vector<HuntIntent>> huntIntents;
+
+    void displayCommon(const Population& pop, size_t i) {
+        cout << "ID: " << pop.id[i] << endl;
+        cout << "Alive: " << (pop.alive[i] ? "Yes" : "No") << endl;
+        cout << "Age: " << pop.age[i] << endl;
+        cout << "Energy: " << pop.energy[i] << endl;
+        cout << "Position: (" << pop.posX[i] << ", " << pop.posY[i] << ")" << endl;
+    }
+
+    // Growth, death roll, reproduction, and photosynthesis for every
+    // plant. Each plant only touches its own slots and appends births
+    // to its chunk's staging buffer, so the loop fans out across the
+    // pool; buffers are merged in chunk order afterwards to keep spawn
+    // order (and thus assigned IDs) deterministic.
+    void plantPhase() {
+        PROF_ZONE("step.plants");
+        double growthChance = WEATHER_TABLE[weather].plantGrowthChance;
+        int boost = WEATHER_TABLE[weather].photosynthesisBoost;
+
+        size_t plantCount = plants.size();
+        double capFactor = 1.0 - (plantCount / 300.0);
+        if (capFactor < 0) capFactor = 0;
+
+        size_t numChunks = (plantCount + CHUNK - 1) / CHUNK;
+        if (plantBirths.size() < numChunks) plantBirths.resize(numChunks);
+        for (size_t c = 0; c < numChunks; c++) plantBirths[c].clear();
+
+        ThreadPool::instance().run(plantCount, CHUNK,
+            [&](size_t begin, size_t end) {
+                vector<Birth>& births = plantBirths[begin / CHUNK];
+
+                for (size_t i = begin; i < end; i++) {
+                    CounterRng rng(seed, day, PHASE_PLANTS, (uint64_t)plants.id[i]);
+
+                    if (plants.alive[i] && rng.next01() < growthChance) {
+                        plants.growthStage[i]++;
+                    }
+
+                    if (plants.growthStage[i] > 5) {
+                        if (rng.next01() < 0.01) plants.kill(i);
+                        else plants.growthStage[i] = 5;
+                    }
+
+                    if (plants.growthStage[i] == 5 && rng.next01() < (0.25 * capFactor)) {
+                        births.push_back({ plants.species[i],
+                            scatter(plants.posX[i], rng.next01()),
+                            scatter(plants.posY[i], rng.next01()) });
+                    }
+
+                    if (plants.alive[i]) {
+                        plants.energy[i] += boost;
+                        if (plants.energy[i] > 30) plants.energy[i] = 30;
+                    }
+                }
+            });
+
+        for (size_t c = 0; c < numChunks; c++)
+            plants.spawnMany(plantBirths[c], 10);
+    }
+
+    // Herbivores wander, then graze the richest plant within reach of
+    // their new position — a localized grid query instead of 5 random
+    // probes scattered across the whole plant vector. Grazing writes
+    // into the shared plant arrays, so this phase stays serial — but
+    // on its own deterministic stream.
+    void animalPhase() {
+        PROF_ZONE("step.animals");
+        int drain = WEATHER_TABLE[weather].herbivoreDrain;
+
+        size_t animalCount = animals.size();
+        double factor = 1.0 - (animalCount / 300.0);
+        if (factor < 0) factor = 0;
+        double reproductionChance = 0.05 * factor;
+
+        plantGrid.build(plants.posX, plants.posY);
+
+        vector<Birth>& newAnimals = animalBirths;
+        newAnimals.clear();
+        for (size_t i = 0; i < animalCount; i++) {
+            animals.age[i]++;
+            if (!animals.alive[i]) continue;
+
+            CounterRng rng(seed, day, PHASE_ANIMALS, (uint64_t)animals.id[i]);
+
+            float x = clampPos(animals.posX[i]
+                + (float)(rng.next01() * 2.0 - 1.0) * WANDER_STEP);
+            float y = clampPos(animals.posY[i]
+                + (float)(rng.next01() * 2.0 - 1.0) * WANDER_STEP);
+            animals.posX[i] = x;
+            animals.posY[i] = y;
+
+            int bestIndex = -1;
+            int bestEnergy = -1;
+            plantGrid.forEachNear(x, y, [&](int idx) {
+                float dx = plants.posX[idx] - x;
+                float dy = plants.posY[idx] - y;
+                if (dx * dx + dy * dy > GRAZE_RADIUS * GRAZE_RADIUS) return;
+                if (plants.energy[idx] > bestEnergy) {
+                    bestEnergy = plants.energy[idx];
+                    bestIndex = idx;
+                }
+            });
+
+            if (bestIndex != -1) {
+                animals.energy[i] += eatPlant(bestIndex, 5);
+            }
+
+            animals.reduceEnergy(i, drain);
+
+            if (animals.energy[i] >= 20 && rng.next01() < reproductionChance) {
+                if (rng.next01() < 0.25 && animals.energy[i] >= 40) {
+                    newAnimals.push_back({ animals.species[i],
+                        scatter(x, rng.next01()), scatter(y, rng.next01()) });
+                    newAnimals.push_back({ animals.species[i],
+                        scatter(x, rng.next01()), scatter(y, rng.next01()) });
+                    animals.energy[i] -= 30;
+                } else {
+                    newAnimals.push_back({ animals.species[i],
+                        scatter(x, rng.next01()), scatter(y, rng.next01()) });
+                    animals.energy[i] -= 15;
+                }
+            }
+
+            if (animals.age[i] > 30 && rng.next01() < 0.1) animals.kill(i);
+        }
+
+        animals.spawnMany(newAnimals, 10);
+    }
+
+    // Hunting is event-batched. A parallel scan pass wanders each
+    // carnivore and emits a hunt intent for the nearest living
+    // herbivore in reach — reads only, against the start-of-phase
+    // animal state. A serial resolution pass then applies kills in
+    // carnivore order (first claim on a prey wins), and a second
+    // parallel pass runs metabolism, reproduction, and old age once
+    // hunt outcomes are settled. Outcomes no longer depend on which
+    // carnivore happened to iterate first over a mutating vector, and
+    // the two heavy passes fan out across the pool.
+    void carnivorePhase() {
+        PROF_ZONE("step.carnivores");
+        int drain = WEATHER_TABLE[weather].carnivoreDrain;
+
+        size_t carnCount = carnivores.size();
+        double factor = 1.0 - (carnCount / 50.0);
+        if (factor < 0) factor = 0;
+        double reproductionChance = 0.02 * factor;
+
+        animalGrid.build(animals.posX, animals.posY);
+
+        size_t numChunks = (carnCount + CHUNK - 1) / CHUNK;
+        if (huntIntents.size() < numChunks) huntIntents.resize(numChunks);
+        if (carnivoreBirths.size() < numChunks) carnivoreBirths.resize(numChunks);
+        for (size_t c = 0; c < numChunks; c++) {
+            huntIntents[c].clear();
+            carnivoreBirths[c].clear();
+        }
+
+        ThreadPool::instance().run(carnCount, CHUNK,
+            [&](size_t begin, size_t end) {
+                vector<HuntIntent>& intents = huntIntents[begin / CHUNK];
+
+                for (size_t i = begin; i < end; i++) {
+                    carnivores.age[i]++;
+                    if (!carnivores.alive[i]) continue;
+
+                    CounterRng rng(seed, day, PHASE_CARNIVORES, (uint64_t)carnivores.id[i]);
+
+                    float x = clampPos(carnivores.posX[i]
+                        + (float)(rng.next01() * 2.0 - 1.0) * WANDER_STEP);
+                    float y = clampPos(carnivores.posY[i]
+                        + (float)(rng.next01() * 2.0 - 1.0) * WANDER_STEP);
+                    carnivores.posX[i] = x;
+                    carnivores.posY[i] = y;
+
+                    if (carnivores.energy[i] < 40) {
+                        int targetIndex = -1;
+                        float bestDist = HUNT_RADIUS * HUNT_RADIUS;
+                        animalGrid.forEachNear(x, y, [&](int idx) {
+                            if (!animals.alive[idx]) return;
+                            float dx = animals.posX[idx] - x;
+                            float dy = animals.posY[idx] - y;
+                            float d = dx * dx + dy * dy;
+                            if (d <= bestDist) {
+                                bestDist = d;
+                                targetIndex = idx;
+                            }
+                        });
+
+                        if (targetIndex != -1) {
+                            intents.push_back({ (uint32_t)i, (uint32_t)targetIndex });
+                        }
+                    }
+                }
+            });
+
+        // Chunks concatenate in carnivore order, so applying intents
+        // in sequence is deterministic regardless of which thread ran
+        // which chunk: the lowest-indexed claimant takes contested prey
+        for (size_t c = 0; c < numChunks; c++) {
+            for (const HuntIntent& h : huntIntents[c]) {
+                if (animals.alive[h.prey]) {
+                    animals.kill(h.prey);
+                    carnivores.energy[h.carnivore] += 25;
+                }
+            }
+        }
+
+        ThreadPool::instance().run(carnCount, CHUNK,
+            [&](size_t begin, size_t end) {
+                vector<Birth>& births = carnivoreBirths[begin / CHUNK];
+
+                for (size_t i = begin; i < end; i++) {
+                    if (!carnivores.alive[i]) continue;
+
+                    CounterRng rng(seed, day, PHASE_CARNIVORES_POST, (uint64_t)carnivores.id[i]);
+
+                    carnivores.reduceEnergy(i, drain);
+
+                    if (carnivores.energy[i] >= 50 && rng.next01() < reproductionChance) {
+                        births.push_back({ carnivores.species[i],
+                            scatter(carnivores.posX[i], rng.next01()),
+                            scatter(carnivores.posY[i], rng.next01()) });
+                        carnivores.energy[i] -= 25;
+                    }
+
+                    if (carnivores.age[i] > 40 && rng.next01() < 0.1) carnivores.kill(i);
+                }
+            });
+
+        for (size_t c = 0; c < numChunks; c++)
+            carnivores.spawnMany(carnivoreBirths[c], 30);
+    }
+
+    // A plant keeps at least 1 energy; returns how much was consumed
+    int eatPlant(size_t idx, int amount) {
+        if (!plants.alive[idx]) return 0;
+        int available = plants.energy[idx] - 1;
+        if (available <= 0) return 0;
+
+        int consumed = min(available, amount);
+        plants.energy[idx] -= consumed;
+        return consumed;
+    }
+
+    // Works for both Population and PlantStore: the PlantStore override
+    // of removeAt also patches growthStage
+    template <typename Store>
+    void compact(Store& pop) {
+        for (size_t i = 0; i < pop.size(); ) {
+            if (!pop.alive[i]) pop.removeAt(i);
+            else i++;
+        }
+    }
+};
+
+// One record per simulated day in the stats log. 24 bytes, 8-byte
+// aligned after the 8-byte header, so analysis tooling can mmap the
+// file and overlay an array of this struct directly; the record count
+// falls out of the file size.
+struct DayStats {
+    uint32_t plants;
+    uint32_t herbivores;
+    uint32_t carnivores;
+    uint32_t weather;     // 0 Clear, 1 Rain, 2 Drought
+    int64_t totalEnergy;
 };
 
-int main() {
+const char STATS_MAGIC[4] = { 'F', 'F', 'S', 'T' };
+const uint32_t STATS_VERSION = 1;
+
+// Buffered binary stats log flushed by a background thread, so the sim
+// loop only ever appends to an in-memory buffer and hands off full
+// chunks — it never blocks on disk.
+class StatsLogger {
+public:
+    explicit StatsLogger(const string& path) {
+        file = fopen(path.c_str(), "wb");
+        if (!file) return;
+        fwrite(STATS_MAGIC, 1, 4, file);
+        fwrite(&STATS_VERSION, sizeof(STATS_VERSION), 1, file);
+        buffer.reserve(FLUSH_RECORDS);
+        writer = thread([this] { run(); });
+    }
+
+    ~StatsLogger() {
+        if (!file) return;
+        {
+            lock_guard<mutex> lock(mtx);
+            if (!buffer.empty()) pending.push_back(move(buffer));
+            stopping = true;
+        }
+        cv.notify_one();
+        writer.join();
+        fclose(file);
+    }
+
+    bool ok() const {
+        return file != nullptr;
+    }
+
+    void record(const DayStats& s) {
+        buffer.push_back(s);
+        if (buffer.size() >= FLUSH_RECORDS) {
+            {
+                lock_guard<mutex> lock(mtx);
+                pending.push_back(move(buffer));
+            }
+            cv.notify_one();
+            buffer.clear();
+            buffer.reserve(FLUSH_RECORDS);
+        }
+    }
+
+private:
+    static const size_t FLUSH_RECORDS = 4096;
+
+    void run() {
+        while (true) {
+            vector<DayStats> chunk;
+            {
+                unique_lock<mutex> lock(mtx);
+                cv.wait(lock, [this] { return stopping || !pending.empty(); });
+                if (pending.empty()) return;
+                chunk = move(pending.front());
+                pending.pop_front();
+            }
+            fwrite(chunk.data(), sizeof(DayStats), chunk.size(), file);
+        }
+    }
+
+    FILE* file = nullptr;
+    vector<DayStats> buffer;
+    deque<vector<DayStats>> pending;
+    mutex mtx;
+    condition_variable cv;
+    thread writer;
+    bool stopping = false;
+};
+
+// Flat-out batch run: no menu, no ANSI clears, no per-day sleep — just
+// N steps with per-day stats streamed to the binary log
+int runBatch(long long days, const string& logPath, uint64_t seed,
+    int plants, int herbivores, int carnivores) {
     World world;
+    world.seed = seed;
+
+    int grass = world.speciesNames.intern("Grass");
+    int deer = world.speciesNames.intern("Deer");
+    int wolf = world.speciesNames.intern("Wolf");
+    for (int i = 0; i < plants; i++) world.addPlant(grass);
+    for (int i = 0; i < herbivores; i++) world.addAnimal(deer);
+    for (int i = 0; i < carnivores; i++) world.addCarnivore(wolf);
+
+    StatsLogger log(logPath);
+    if (!log.ok()) {
+        cerr << "Failed to open stats log: " << logPath << endl;
+        return 1;
+    }
+
+    for (long long d = 0; d < days; d++) {
+        world.step();
+        log.record({ (uint32_t)world.plants.size(),
+            (uint32_t)world.animals.size(),
+            (uint32_t)world.carnivores.size(),
+            world.weatherCode(),
+            (int64_t)world.totalEnergy() });
+    }
 
-    for (int i = 0; i < 10; i++) {
-        world.plants.push_back(Plant("Grass"));
+    cout << "Simulated " << days << " days (seed " << seed << ")" << endl;
+    world.displayStats();
+
+    if (prof::enabled()) {
+        prof::dump("florafauna_profile.csv");
+        cout << prof::overlayText();
     }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    long long batchDays = 0;
+    string logPath = "stats.bin";
+    uint64_t seed = 1;
+    int startPlants = 10;
+    int startHerbivores = 0;
+    int startCarnivores = 0;
+
+    // Flags apply left to right, so explicit flags after --scenario
+    // override the scenario's values
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--batch" && i + 1 < argc) batchDays = atoll(argv[++i]);
+        else if (arg == "--log" && i + 1 < argc) logPath = argv[++i];
+        else if (arg == "--seed" && i + 1 < argc) seed = strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--herbivores" && i + 1 < argc) startHerbivores = atoi(argv[++i]);
+        else if (arg == "--carnivores" && i + 1 < argc) startCarnivores = atoi(argv[++i]);
+        else if (arg == "--scenario" && i + 1 < argc) {
+            scn::Scenario s;
+            string err;
+            if (!scn::load(argv[++i], s, err)) {
+                cerr << err << endl;
+                return 1;
+            }
+            seed = s.seed;
+            startPlants = s.plants;
+            startHerbivores = s.herbivores;
+            startCarnivores = s.carnivores;
+        }
+        else if (arg == "--profile") prof::setEnabled(true);
+        else {
+            cerr << "Usage: " << argv[0]
+                 << " [--batch DAYS] [--log FILE] [--seed N]"
+                 << " [--herbivores N] [--carnivores N]"
+                 << " [--scenario FILE] [--profile]" << endl;
+            return 1;
+        }
+    }
+
+    if (batchDays > 0) {
+        return runBatch(batchDays, logPath, seed, startPlants,
+            startHerbivores, startCarnivores);
+    }
+
+    World world;
+    world.seed = seed;
+
+    int grass = world.speciesNames.intern("Grass");
+    int deer = world.speciesNames.intern("Deer");
+    int wolf = world.speciesNames.intern("Wolf");
+    for (int i = 0; i < startPlants; i++) world.addPlant(grass);
+    for (int i = 0; i < startHerbivores; i++) world.addAnimal(deer);
+    for (int i = 0; i < startCarnivores; i++) world.addCarnivore(wolf);
 
     while (true) {
         cout << "\033[2J\033[1;1H";
@@ -368,7 +1065,7 @@ int main() {
 
         int choice;
         if (!(cin >> choice)) {
-            break; 
+            break;
         }
 
         if (choice == 1) {
@@ -389,27 +1086,27 @@ int main() {
             string sp;
             cout << "Species: ";
             cin >> sp;
-            world.animals.push_back(Animal(sp));
+            world.addAnimal(world.speciesNames.intern(sp));
         }
         else if (choice == 4) {
             string sp;
             cout << "Species: ";
             cin >> sp;
-            world.carnivores.push_back(Carnivore(sp));
+            world.addCarnivore(world.speciesNames.intern(sp));
         }
         else if (choice == 5) {
             cout << "\033[2J\033[1;1H";
             cout << "--- Entity List ---\n";
             int listIndex = 1;
 
-            for (int i = 0; i < world.animals.size(); i++) {
-                cout << "[" << listIndex++ << "] Herbivore (" << world.animals[i].getID() << ")\n";
+            for (size_t i = 0; i < world.animals.size(); i++) {
+                cout << "[" << listIndex++ << "] Herbivore (" << world.animals.id[i] << ")\n";
             }
-            for (int i = 0; i < world.carnivores.size(); i++) {
-                cout << "[" << listIndex++ << "] Carnivore (" << world.carnivores[i].getID() << ")\n";
+            for (size_t i = 0; i < world.carnivores.size(); i++) {
+                cout << "[" << listIndex++ << "] Carnivore (" << world.carnivores.id[i] << ")\n";
             }
-            for (int i = 0; i < world.plants.size(); i++) {
-                cout << "[" << listIndex++ << "] Plant (" << world.plants[i].getID() << ")\n";
+            for (size_t i = 0; i < world.plants.size(); i++) {
+                cout << "[" << listIndex++ << "] Plant (" << world.plants.id[i] << ")\n";
             }
 
             cout << "\nPress Enter to return...";
@@ -417,47 +1114,15 @@ int main() {
             cin.get();
         }
         else if (choice == 6) {
-            int menuChoice;
-            cout << "Enter Menu Index (from List Entities): ";
-            cin >> menuChoice;
+            long long entityID;
+            cout << "Enter Entity ID (from List Entities): ";
+            cin >> entityID;
 
             cout << "\033[2J\033[1;1H";
-            bool found = false;
-            int currentIndex = 1;
-
-            for (int i = 0; i < world.animals.size(); i++) {
-                if (currentIndex == menuChoice) {
-                    world.animals[i].displayInfo();
-                    found = true;
-                    break;
-                }
-                currentIndex++;
-            }
-
-            if (!found) {
-                for (int i = 0; i < world.carnivores.size(); i++) {
-                    if (currentIndex == menuChoice) {
-                        world.carnivores[i].displayInfo();
-                        found = true;
-                        break;
-                    }
-                    currentIndex++;
-                }
+            if (!world.inspectByID(entityID)) {
+                cout << "Entity ID not found.\n";
             }
 
-            if (!found) {
-                for (int i = 0; i < world.plants.size(); i++) {
-                    if (currentIndex == menuChoice) {
-                        world.plants[i].displayInfo();
-                        found = true;
-                        break;
-                    }
-                    currentIndex++;
-                }
-            }
-
-            if (!found) cout << "Entity index not found.\n";
-
             cout << "\nPress Enter to return...";
             cin.ignore(10000, '\n');
             cin.get();
@@ -467,5 +1132,7 @@ int main() {
         }
     }
 
+    if (prof::enabled()) prof::dump("florafauna_profile.csv");
+
     return 0;
-}
\ No newline at end of file
+}
@@ -7,86 +7,283 @@
 #include <chrono>
 #include <string>
 #include <cstdlib>
+#include <cmath>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <map>
+#include <cstdint>
+#include <cstdio>
 #include <curl/curl.h>
 #include <nlohmann/json.hpp>
 
+#include "../Common/profiler.hpp"
+#include "../Common/scenario.hpp"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h> // MoveFileExA: atomic save-file replacement
+#endif
+
 using namespace std;
 using json = nlohmann::json;
 
-const string DB_URL = "https://hoard-39f9c-default-rtdb.asia-southeast1.firebasedatabase.app";
+// Overridable via --scenario (see Common/scenario.hpp), so a staging
+// database or alternate pricing can be pointed at without a rebuild
+string DB_URL = "https://hoard-39f9c-default-rtdb.asia-southeast1.firebasedatabase.app";
+long long IDLE_UPGRADE_COST = 5000;
+long long LUCK_UPGRADE_COST = 8000;
+
+// Units are stored as integer micro-units (1 unit = 1,000,000 micro) in an
+// atomic counter. The idle thread adds with fetch_add and the main thread
+// deducts with a compare-exchange loop, so both sides stay race-free
+// without ever blocking — and integer fixed-point means no increments are
+// lost to floating-point rounding either.
+const long long UNIT_SCALE = 1000000;
 
 struct Player {
     string name;
-    double units = 0.0;
-    double rate = 1.0;
+    atomic<long long> microUnits{ 0 };
+    atomic<double> rate{ 1.0 };
     long long lastSaved = 0;
-    double idleBonus = 0.0;
-    double doubleInvestChance = 0.0;
+    atomic<double> idleBonus{ 0.0 };
+    atomic<double> doubleInvestChance{ 0.0 };
 };
 
+double unitsOf(const Player& p) {
+    return p.microUnits.load() / (double)UNIT_SCALE;
+}
+
+// Idle-thread side: a single wait-free fetch_add per tick
+void addUnits(Player& p, double amount) {
+    p.microUnits.fetch_add((long long)llround(amount * UNIT_SCALE));
+}
+
+// Main-thread side: atomically checks the balance and deducts in one CAS
+// loop, so a concurrent idle tick can never be overwritten and the balance
+// can never go negative.
+bool trySpend(Player& p, double cost) {
+    long long c = (long long)llround(cost * UNIT_SCALE);
+    long long current = p.microUnits.load();
+
+    while (current >= c) {
+        if (p.microUnits.compare_exchange_weak(current, current - c))
+            return true;
+        // CAS failure reloaded `current`; retry against the fresh balance
+    }
+    return false;
+}
+
 // Returns current timestamp for save/load calculations
 long long now() {
     return time(nullptr);
 }
 
+// ---------------------------------------------------------------
+// Economy formulas — single source of truth
+//
+// The live idle loop, offline progress, and the batch simulator all
+// go through these helpers, so the formulas can no longer drift apart
+// the way the old inline 1.0+idleBonus / 0.10+idleBonus copies did.
+// (Offline earning less than online is intentional; the 0.10 base is
+// the design knob, not a bug.)
+// ---------------------------------------------------------------
+const double OFFLINE_BASE_EFFICIENCY = 0.10;
+
+double idleMultiplier(double idleBonus) {
+    return 1.0 + min(idleBonus, 1.0);
+}
+
+double offlineEfficiency(double idleBonus) {
+    return OFFLINE_BASE_EFFICIENCY + min(idleBonus, 1.0);
+}
+
+// Diminishing returns on investment:
+// larger investments yield more rate, but cost efficiency drops as the
+// amount scales. +1000 in the denominator prevents early-game explosion.
+double investRateGain(double amount) {
+    double gain = (amount * amount) / (amount + 1000.0);
+    return gain * 0.001;
+}
+
+// Advances the live economy by `seconds` ticks in closed form. The
+// per-second gain is constant between upgrades, so N ticks collapse to
+// one multiply — balance rigs fast-forward months in microseconds
+// instead of sleeping through them or re-deriving the formulas.
+void simulateTicks(Player& p, long long seconds) {
+    addUnits(p, p.rate.load() * idleMultiplier(p.idleBonus.load()) * seconds);
+}
+
+// Scripted investment schedule for balance testing: `count` investments
+// of `amount`, each only if affordable, with the double-invest luck
+// applied as its expected value so runs are deterministic.
+void simulateInvestSchedule(Player& p, double amount, long long count) {
+    double expectedLuck = 1.0 + min(p.doubleInvestChance.load(), 0.05);
+
+    for (long long i = 0; i < count; i++) {
+        if (!trySpend(p, amount))
+            break;
+        p.rate.store(p.rate.load()
+            + investRateGain(amount) * expectedLuck);
+    }
+}
+
+// ---------------------------------------------------------------
+// Save system
+//
+// save.bin layout (version 1, little-endian):
+//   char[4]  magic "HSV1"
+//   uint32   name length, then the name bytes
+//   int64    microUnits   (exact integer — no float round trip)
+//   double   rate, idleBonus, doubleInvestChance
+//   int64    savedAt timestamp
+//
+// Writes go to a temp file which then replaces the real save in one
+// rename, so a crash mid-write leaves the previous save intact. The
+// idle thread autosaves every 30s; all fields it reads are atomic.
+// ---------------------------------------------------------------
+const char* SAVE_FILE = "save.bin";
+const char* SAVE_TMP = "save.bin.tmp";
+const char* LEGACY_SAVE_FILE = "save.txt"; // pre-binary saves, read once
+const int AUTOSAVE_SECONDS = 30;
+
+// The idle thread's autosave and the main thread's exit save share one
+// temp file; without this lock their interleaved writes could be
+// renamed over the real save as one corrupt file
+mutex saveMtx;
+
 void saveGame(const Player& p) {
-    ofstream f("save.txt");
-    f << p.name << "\n"
-        << p.units << "\n"
-        << p.rate << "\n"
-        << now() << "\n"
-        << p.idleBonus << "\n"
-        << p.doubleInvestChance << "\n";
+    PROF_ZONE("saveGame");
+    lock_guard<mutex> saveLock(saveMtx);
+    {
+        ofstream f(SAVE_TMP, ios::binary | ios::trunc);
+        if (!f) return;
+
+        uint32_t nameLen = (uint32_t)p.name.size();
+        long long micro = p.microUnits.load();
+        double rate = p.rate.load();
+        double idleBonus = p.idleBonus.load();
+        double luck = p.doubleInvestChance.load();
+        long long savedAt = now();
+
+        f.write("HSV1", 4);
+        f.write((const char*)&nameLen, sizeof(nameLen));
+        f.write(p.name.data(), nameLen);
+        f.write((const char*)&micro, sizeof(micro));
+        f.write((const char*)&rate, sizeof(rate));
+        f.write((const char*)&idleBonus, sizeof(idleBonus));
+        f.write((const char*)&luck, sizeof(luck));
+        f.write((const char*)&savedAt, sizeof(savedAt));
+
+        if (!f) return; // partial write: keep the old save
+    }
+
+    // Atomic replace: the save file always holds a complete record
+#if defined(_WIN32)
+    MoveFileExA(SAVE_TMP, SAVE_FILE,
+        MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+#else
+    rename(SAVE_TMP, SAVE_FILE);
+#endif
 }
 
-bool loadGame(Player& p) {
-    ifstream f("save.txt");
+// Applies offline progress to a freshly loaded state:
+// players earn partial resources (10% base + idleBonus) for time away.
+void applyOfflineProgress(Player& p, double units, double rate,
+    double idleBonus, long long savedAt) {
+    long long elapsed = now() - savedAt;
+    units += rate * elapsed * offlineEfficiency(idleBonus);
+
+    p.microUnits.store((long long)llround(units * UNIT_SCALE));
+    p.rate.store(rate);
+    p.idleBonus.store(idleBonus);
+    p.lastSaved = now();
+}
+
+bool loadGameBinary(Player& p) {
+    ifstream f(SAVE_FILE, ios::binary);
+    if (!f) return false;
+
+    char magic[4];
+    f.read(magic, 4);
+    if (!f || string(magic, 4) != "HSV1") return false;
+
+    uint32_t nameLen = 0;
+    f.read((char*)&nameLen, sizeof(nameLen));
+    if (!f || nameLen > 256) return false;
+
+    string name(nameLen, '\0');
+    f.read(&name[0], nameLen);
+
+    long long micro, savedAt;
+    double rate, idleBonus, luck;
+    f.read((char*)&micro, sizeof(micro));
+    f.read((char*)&rate, sizeof(rate));
+    f.read((char*)&idleBonus, sizeof(idleBonus));
+    f.read((char*)&luck, sizeof(luck));
+    f.read((char*)&savedAt, sizeof(savedAt));
+    if (!f) return false;
+
+    p.name = name;
+    p.doubleInvestChance.store(luck);
+    applyOfflineProgress(p, micro / (double)UNIT_SCALE,
+        rate, idleBonus, savedAt);
+    return true;
+}
+
+// One-time migration path for saves from the old text format
+bool loadGameLegacy(Player& p) {
+    ifstream f(LEGACY_SAVE_FILE);
     if (!f) return false;
 
     long long old;
-    f >> p.name >> p.units >> p.rate >> old
-        >> p.idleBonus >> p.doubleInvestChance;
-
-    // Calculate offline progress:
-    // Players earn partial resources (10% base + idleBonus) for time spent away.
-    long long elapsed = now() - old;
-    double efficiency = 0.10 + min(p.idleBonus, 1.0);
-    p.units += p.rate * elapsed * efficiency;
-    p.lastSaved = now();
+    double units, rate, idleBonus, luck;
+    f >> p.name >> units >> rate >> old >> idleBonus >> luck;
+    if (!f) return false;
+
+    p.doubleInvestChance.store(luck);
+    applyOfflineProgress(p, units, rate, idleBonus, old);
     return true;
 }
 
+bool loadGame(Player& p) {
+    return loadGameBinary(p) || loadGameLegacy(p);
+}
+
 // Background thread function to handle passive resource gain
-// Independent of user input to ensure real-time progression
+// Independent of user input to ensure real-time progression.
+// Doubles as the autosave cadence: every 30 ticks it snapshots the
+// (entirely atomic) player state without touching the menu loop.
 void idleGain(Player& p) {
+    int ticks = 0;
     while (true) {
         this_thread::sleep_for(chrono::seconds(1));
-        double multiplier = 1.0 + min(p.idleBonus, 1.0);
-        p.units += p.rate * multiplier;
+        simulateTicks(p, 1);
+
+        if (++ticks % AUTOSAVE_SECONDS == 0)
+            saveGame(p);
     }
 }
 
 void invest(Player& p, double amount) {
-    if (p.units < amount) {
+    if (!trySpend(p, amount)) {
         cout << "Not enough units.\n";
         return;
     }
 
-    p.units -= amount;
-
-    // Diminishing returns formula:
-    // Larger investments yield more rate, but cost efficiency drops as amount scales.
-    // Adds +1000 to denominator to prevent early game exponential explosion.
-    double gain = (amount * amount) / (amount + 1000.0);
-    double rateIncrease = gain * 0.001;
+    double rateIncrease = investRateGain(amount);
 
     double roll = (double)rand() / RAND_MAX;
-    if (roll < min(p.doubleInvestChance, 0.05)) {
+    if (roll < min(p.doubleInvestChance.load(), 0.05)) {
         rateIncrease *= 2.0;
         cout << "Lucky! Investment doubled.\n";
     }
 
-    p.rate += rateIncrease;
+    // Only the main thread writes rate; the idle thread just reads it
+    p.rate.store(p.rate.load() + rateIncrease);
 }
 
 // cURL WriteCallback:
@@ -96,36 +293,345 @@ size_t writeCallback(void* c, size_t s, size_t n, string* out) {
     return s * n;
 }
 
-json fetchLeaderboard() {
-    CURL* curl = curl_easy_init();
-    string response;
+// ---------------------------------------------------------------
+// Asynchronous network layer
+//
+// All transfers run on one worker thread driving a curl_multi handle;
+// game code enqueues a request with a completion callback and keeps
+// running. Callbacks fire on the main thread from poll(), so they can
+// touch game state without locking. Easy handles are recycled through
+// a small pool instead of init/cleanup per call — the connection (and
+// its TLS session) stays alive between requests to the same host.
+// ---------------------------------------------------------------
+// Everything a completion callback might care about: transport success,
+// HTTP status (304 = cached copy still valid), body, and the entity tag
+// the server attached for future conditional requests.
+struct NetResponse {
+    bool ok = false;
+    long status = 0;
+    string body;
+    string etag;
+};
 
-    curl_easy_setopt(curl, CURLOPT_URL, (DB_URL + "/leaderboard.json").c_str());
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeCallback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
+// Captures the ETag response header as it streams past
+size_t headerCallback(char* buf, size_t s, size_t n, string* etag) {
+    string line(buf, s * n);
+    const string key = "etag:";
+
+    if (line.size() > key.size()) {
+        string lower = line.substr(0, key.size());
+        for (char& c : lower) c = (char)tolower(c);
+
+        if (lower == key) {
+            string value = line.substr(key.size());
+            // Trim whitespace/CRLF
+            size_t b = value.find_first_not_of(" \t\r\n");
+            size_t e = value.find_last_not_of(" \t\r\n");
+            if (b != string::npos)
+                *etag = value.substr(b, e - b + 1);
+        }
+    }
+    return s * n;
+}
 
-    curl_easy_perform(curl);
-    curl_easy_cleanup(curl);
+class NetworkClient {
+public:
+    using Handler = function<void(const NetResponse&)>;
 
-    if (response == "null")
-        return json::object();
+    NetworkClient() {
+        curl_global_init(CURL_GLOBAL_DEFAULT);
+        multi = curl_multi_init();
 
-    return json::parse(response);
-}
+        // Connection pooling with HTTP/2 multiplexing: all requests to
+        // the Firebase host share a single persistent connection, and
+        // concurrent transfers ride it as parallel streams instead of
+        // opening (and TLS-handshaking) one connection each.
+        curl_multi_setopt(multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+        curl_multi_setopt(multi, CURLMOPT_MAX_HOST_CONNECTIONS, 1L);
 
-void uploadScore(const Player& p) {
-    CURL* curl = curl_easy_init();
-    if (!curl) return;
+        worker = thread(&NetworkClient::run, this);
+    }
 
-    string url = DB_URL + "/leaderboard/" + p.name + ".json";
-    string payload = to_string(p.units);
+    ~NetworkClient() {
+        {
+            lock_guard<mutex> lk(queueMutex);
+            stopping = true;
+        }
+        queueCv.notify_all();
+        worker.join();
+
+        for (CURL* h : handlePool)
+            curl_easy_cleanup(h);
+        curl_multi_cleanup(multi);
+        curl_global_cleanup();
+    }
+
+    void get(const string& url, Handler onDone) {
+        enqueue({ url, "GET", "", {}, move(onDone) });
+    }
+
+    void get(const string& url, vector<string> headers, Handler onDone) {
+        enqueue({ url, "GET", "", move(headers), move(onDone) });
+    }
+
+    void put(const string& url, const string& body, Handler onDone) {
+        enqueue({ url, "PUT", body, {}, move(onDone) });
+    }
+
+    // Runs finished requests' callbacks on the calling thread.
+    // Call once per pass of the main loop.
+    void poll() {
+        deque<Completed> ready;
+        {
+            lock_guard<mutex> lk(doneMutex);
+            ready.swap(completed);
+        }
+
+        for (auto& c : ready) {
+            if (c.onDone)
+                c.onDone(c.response);
+            pending.fetch_sub(1);
+        }
+    }
+
+    // Polls until every in-flight request has completed and its
+    // callback has run. Used on the exit path.
+    void drain() {
+        while (pending.load() > 0) {
+            poll();
+            this_thread::sleep_for(chrono::milliseconds(10));
+        }
+    }
+
+private:
+    struct Request {
+        string url;
+        string method;
+        string body;
+        vector<string> headers;
+        Handler onDone;
+    };
+
+    struct Completed {
+        Handler onDone;
+        NetResponse response;
+    };
+
+    // One in-flight transfer; owns the response buffers the write and
+    // header callbacks fill in
+    struct Transfer {
+        Request req;
+        string response;
+        string etag;
+        curl_slist* headerList = nullptr;
+        chrono::steady_clock::time_point started;
+    };
+
+    void enqueue(Request r) {
+        pending.fetch_add(1);
+        {
+            lock_guard<mutex> lk(queueMutex);
+            queue.push_back(move(r));
+        }
+        queueCv.notify_one();
+    }
+
+    CURL* acquireHandle() {
+        if (handlePool.empty())
+            return curl_easy_init();
+        CURL* h = handlePool.back();
+        handlePool.pop_back();
+        return h;
+    }
+
+    void releaseHandle(CURL* h) {
+        // Reset options but keep the handle (and its live connection)
+        curl_easy_reset(h);
+        handlePool.push_back(h);
+    }
+
+    void startTransfer(Request r) {
+        auto t = make_unique<Transfer>();
+        t->req = move(r);
+        t->started = chrono::steady_clock::now();
+
+        CURL* h = acquireHandle();
+        curl_easy_setopt(h, CURLOPT_URL, t->req.url.c_str());
+        curl_easy_setopt(h, CURLOPT_WRITEFUNCTION, writeCallback);
+        curl_easy_setopt(h, CURLOPT_WRITEDATA, &t->response);
+        curl_easy_setopt(h, CURLOPT_NOSIGNAL, 1L);
+        curl_easy_setopt(h, CURLOPT_TCP_KEEPALIVE, 1L);
+        curl_easy_setopt(h, CURLOPT_TIMEOUT_MS, 10000L);
+        curl_easy_setopt(h, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+        // Wait for the existing connection's multiplex capability
+        // instead of racing a second connection open
+        curl_easy_setopt(h, CURLOPT_PIPEWAIT, 1L);
+        curl_easy_setopt(h, CURLOPT_HEADERFUNCTION, headerCallback);
+        curl_easy_setopt(h, CURLOPT_HEADERDATA, &t->etag);
+
+        for (const string& header : t->req.headers)
+            t->headerList = curl_slist_append(t->headerList, header.c_str());
+        if (t->headerList)
+            curl_easy_setopt(h, CURLOPT_HTTPHEADER, t->headerList);
+
+        if (t->req.method == "PUT") {
+            curl_easy_setopt(h, CURLOPT_CUSTOMREQUEST, "PUT");
+            curl_easy_setopt(h, CURLOPT_POSTFIELDS, t->req.body.c_str());
+        }
+
+        curl_multi_add_handle(multi, h);
+        active[h] = move(t);
+    }
+
+    void finishTransfer(CURL* h, CURLcode result) {
+        auto it = active.find(h);
+        if (it == active.end())
+            return;
+
+        // Wall-clock transfer latency, queue-to-done, as a zone sample
+        if (prof::enabled()) {
+            static const int netZone =
+                prof::Profiler::instance().registerZone("net.transfer");
+            prof::Profiler::instance().record(netZone,
+                chrono::duration<double, micro>(
+                    chrono::steady_clock::now() - it->second->started).count());
+        }
+
+        Completed c;
+        c.onDone = move(it->second->req.onDone);
+        c.response.ok = (result == CURLE_OK);
+        c.response.body = move(it->second->response);
+        c.response.etag = move(it->second->etag);
+        curl_easy_getinfo(h, CURLINFO_RESPONSE_CODE, &c.response.status);
+
+        if (it->second->headerList)
+            curl_slist_free_all(it->second->headerList);
+
+        active.erase(it);
+        curl_multi_remove_handle(multi, h);
+        releaseHandle(h);
+
+        {
+            lock_guard<mutex> lk(doneMutex);
+            completed.push_back(move(c));
+        }
+    }
+
+    void run() {
+        while (true) {
+            // Pull queued requests; sleep only when fully idle
+            {
+                unique_lock<mutex> lk(queueMutex);
+                if (queue.empty() && active.empty()) {
+                    queueCv.wait(lk, [this] {
+                        return stopping || !queue.empty();
+                        });
+                }
+                if (stopping)
+                    return;
+
+                while (!queue.empty()) {
+                    Request r = move(queue.front());
+                    queue.pop_front();
+                    lk.unlock();
+                    startTransfer(move(r));
+                    lk.lock();
+                }
+            }
+
+            int running = 0;
+            curl_multi_perform(multi, &running);
+            curl_multi_wait(multi, nullptr, 0, 50, nullptr);
+
+            int msgsLeft = 0;
+            while (CURLMsg* msg = curl_multi_info_read(multi, &msgsLeft)) {
+                if (msg->msg == CURLMSG_DONE)
+                    finishTransfer(msg->easy_handle, msg->data.result);
+            }
+        }
+    }
 
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, "PUT");
-    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, payload.c_str());
+    CURLM* multi = nullptr;
+    thread worker;
 
-    curl_easy_perform(curl);
-    curl_easy_cleanup(curl);
+    mutex queueMutex;
+    condition_variable queueCv;
+    deque<Request> queue;
+    bool stopping = false;
+
+    mutex doneMutex;
+    deque<Completed> completed;
+    atomic<int> pending{ 0 };
+
+    // Worker-thread-only state
+    map<CURL*, unique_ptr<Transfer>> active;
+    vector<CURL*> handlePool;
+};
+
+NetworkClient* net = nullptr;
+
+// Local leaderboard cache, refreshed in the background.
+// Only touched from the main thread (callbacks run inside net->poll()).
+//
+// Three layers keep the cost of a view down now that boards run to tens
+// of thousands of players:
+//   1. TTL     — views within 30s reuse the cache, no request at all
+//   2. ETag    — conditional fetch; an unchanged board answers 304 with
+//                no body (Firebase needs the X-Firebase-ETag header)
+//   3. Query   — orderBy/limitToLast makes the server send only the top
+//                entries instead of the whole document
+json leaderboard = json::object();
+bool leaderboardLoaded = false;
+long long leaderboardFetchedAt = 0;
+string leaderboardETag;
+
+const int LEADERBOARD_TTL_SECONDS = 30;
+const int LEADERBOARD_FETCH_COUNT = 50; // fetch a few screens' worth
+
+void refreshLeaderboard() {
+    if (leaderboardLoaded
+        && now() - leaderboardFetchedAt < LEADERBOARD_TTL_SECONDS)
+        return; // cache is fresh enough
+
+    // orderBy="$value"&limitToLast=N, URL-encoded
+    string url = DB_URL + "/leaderboard.json"
+        "?orderBy=%22%24value%22&limitToLast="
+        + to_string(LEADERBOARD_FETCH_COUNT);
+
+    vector<string> headers = { "X-Firebase-ETag: true" };
+    if (!leaderboardETag.empty())
+        headers.push_back("if-none-match: " + leaderboardETag);
+
+    net->get(url, move(headers), [](const NetResponse& r) {
+        if (!r.ok) return;
+
+        leaderboardFetchedAt = now();
+
+        if (r.status == 304) {
+            // Board unchanged since last fetch; keep the cache
+            return;
+        }
+
+        leaderboard = (r.body == "null")
+            ? json::object()
+            : json::parse(r.body, nullptr, false);
+        if (leaderboard.is_discarded())
+            leaderboard = json::object();
+
+        leaderboardETag = r.etag;
+        leaderboardLoaded = true;
+        });
+}
+
+// Fire-and-forget; onDone may be empty
+void uploadScore(const Player& p, NetworkClient::Handler onDone = {}) {
+    string url = DB_URL + "/leaderboard/" + p.name + ".json";
+    net->put(url, to_string(unitsOf(p)), move(onDone));
+
+    // Our own score changed the board; drop the conditional-fetch state
+    // so the next refresh pulls the updated document.
+    leaderboardETag.clear();
+    leaderboardFetchedAt = 0;
 }
 
 void showLeaderboard(const json& board) {
@@ -134,13 +640,16 @@ void showLeaderboard(const json& board) {
     for (auto& [name, units] : board.items())
         entries.push_back({ name, units });
 
-    sort(entries.begin(), entries.end(),
+    // Only the top 10 need ordering: partial_sort is O(N log 10)
+    // instead of a full O(N log N) sort of the board
+    size_t shown = min<size_t>(10, entries.size());
+    partial_sort(entries.begin(), entries.begin() + shown, entries.end(),
         [](auto& a, auto& b) {
             return a.second > b.second;
         });
 
     cout << "\nTOP 10\n";
-    for (int i = 0; i < entries.size() && i < 10; i++) {
+    for (size_t i = 0; i < shown; i++) {
         cout << i + 1 << ". "
             << entries[i].first << " : "
             << entries[i].second << "\n";
@@ -149,25 +658,23 @@ void showLeaderboard(const json& board) {
 
 void unlockMenu(Player& p) {
     cout << "\nUNLOCKS\n";
-    cout << "Idle Bonus: " << p.idleBonus * 100 << "%\n";
-    cout << "Double Invest Chance: " << p.doubleInvestChance * 100 << "%\n\n";
+    cout << "Idle Bonus: " << p.idleBonus.load() * 100 << "%\n";
+    cout << "Double Invest Chance: " << p.doubleInvestChance.load() * 100 << "%\n\n";
 
-    cout << "1. +5% Idle Gain (5000 units)\n";
-    cout << "2. +0.05% Double Invest Chance (8000 units)\n";
+    cout << "1. +5% Idle Gain (" << IDLE_UPGRADE_COST << " units)\n";
+    cout << "2. +0.05% Double Invest Chance (" << LUCK_UPGRADE_COST << " units)\n";
     cout << "0. Back\n";
     cout << "Choice: ";
 
     int c;
     cin >> c;
 
-    if (c == 1 && p.idleBonus < 1.0 && p.units >= 5000) {
-        p.units -= 5000;
-        p.idleBonus += 0.05;
+    if (c == 1 && p.idleBonus.load() < 1.0 && trySpend(p, (double)IDLE_UPGRADE_COST)) {
+        p.idleBonus.store(p.idleBonus.load() + 0.05);
         cout << "Idle gain upgraded.\n";
     }
-    else if (c == 2 && p.doubleInvestChance < 0.05 && p.units >= 8000) {
-        p.units -= 8000;
-        p.doubleInvestChance += 0.0005;
+    else if (c == 2 && p.doubleInvestChance.load() < 0.05 && trySpend(p, (double)LUCK_UPGRADE_COST)) {
+        p.doubleInvestChance.store(p.doubleInvestChance.load() + 0.0005);
         cout << "Investment luck upgraded.\n";
     }
 }
@@ -178,17 +685,56 @@ void sanitizeName(string& name) {
 }
 
 bool loadSavedName(string& savedName) {
-    ifstream f("save.txt");
-    if (!f) return false;
-    getline(f, savedName);
+    // Binary save first, falling back to a legacy text save
+    ifstream f(SAVE_FILE, ios::binary);
+    if (f) {
+        char magic[4];
+        uint32_t nameLen = 0;
+        f.read(magic, 4);
+        f.read((char*)&nameLen, sizeof(nameLen));
+        if (f && string(magic, 4) == "HSV1" && nameLen <= 256) {
+            savedName.resize(nameLen);
+            f.read(&savedName[0], nameLen);
+            return (bool)f;
+        }
+        return false;
+    }
+
+    ifstream legacy(LEGACY_SAVE_FILE);
+    if (!legacy) return false;
+    getline(legacy, savedName);
     return true;
 }
 
-int main() {
+int main(int argc, char** argv) {
     srand((unsigned)time(nullptr));
 
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--profile") {
+            prof::setEnabled(true);
+        }
+        else if (arg == "--scenario" && i + 1 < argc) {
+            scn::Scenario s;
+            string err;
+            if (!scn::load(argv[++i], s, err)) {
+                cerr << err << "\n";
+                return 1;
+            }
+            if (!s.dbUrl.empty()) DB_URL = s.dbUrl;
+            IDLE_UPGRADE_COST = s.idleUpgradeCost;
+            LUCK_UPGRADE_COST = s.luckUpgradeCost;
+        }
+    }
+
+    NetworkClient client;
+    net = &client;
+
     Player p;
-    json leaderboard = fetchLeaderboard();
+
+    // Start the leaderboard download immediately; it overlaps the time
+    // the player spends typing a name instead of blocking before it.
+    refreshLeaderboard();
 
     string savedName;
     bool hasSave = loadSavedName(savedName);
@@ -199,18 +745,38 @@ int main() {
         cin >> p.name;
         sanitizeName(p.name);
 
-        if (!leaderboard.contains(p.name))
+        if (hasSave && p.name == savedName)
             break;
 
-        if (hasSave && p.name == savedName)
+        // The truncated leaderboard cache can't answer "is this name
+        // taken" — ask the server for the single key instead (a few
+        // bytes either way). Bounded wait so a dead connection can't
+        // lock the menu forever. The flags live on the heap, captured
+        // by value: this loop can give up before the transfer's own
+        // timeout fires, and the handler then runs from a later
+        // poll() in the game loop, after this stack frame is gone.
+        struct NameCheck { bool answered = false; bool taken = false; };
+        auto check = make_shared<NameCheck>();
+        net->get(DB_URL + "/leaderboard/" + p.name + ".json",
+            [check](const NetResponse& r) {
+                check->answered = true;
+                check->taken = r.ok && r.body != "null";
+            });
+
+        for (int waited = 0; !check->answered && waited < 500; ++waited) {
+            net->poll();
+            this_thread::sleep_for(chrono::milliseconds(10));
+        }
+
+        if (!check->taken)
             break;
 
         cout << "Name already taken by another player. Try again.\n";
     }
 
     if (!loadGame(p)) {
-        p.units = 0;
-        p.rate = 1;
+        p.microUnits.store(0);
+        p.rate.store(1.0);
     }
 
     // Launch background thread for resource accumulation
@@ -218,9 +784,11 @@ int main() {
 
     // Main Game Loop
     while (true) {
+        net->poll(); // consume any finished background requests
+
         cout << "\n----------------------------------\n";
-        cout << "Units: " << p.units << "\n";
-        cout << "Rate : " << p.rate << " / sec\n";
+        cout << "Units: " << unitsOf(p) << "\n";
+        cout << "Rate : " << p.rate.load() << " / sec\n";
         cout << "----------------------------------\n";
         cout << "1. Invest\n";
         cout << "2. View Leaderboard\n";
@@ -238,8 +806,11 @@ int main() {
             invest(p, amount);
         }
         else if (choice == 2) {
-            leaderboard = fetchLeaderboard();
+            // Show the cached board immediately and refresh in the
+            // background; the updated board appears on the next view.
+            refreshLeaderboard();
             showLeaderboard(leaderboard);
+            cout << "(refreshing in background)\n";
             cout << "\nPress Enter...";
             cin.ignore();
             cin.get();
@@ -249,11 +820,30 @@ int main() {
         }
         else if (choice == 4) {
             saveGame(p);
+
+            // One round trip: the score upload and the board fetch are
+            // issued together and multiplex over the same HTTP/2
+            // connection instead of running back-to-back.
             uploadScore(p);
-            leaderboard = fetchLeaderboard();
+            refreshLeaderboard();
+            net->drain();
+
+            // The concurrent fetch may have raced our upload on the
+            // server; overlay our own score so the final board always
+            // reflects it.
+            leaderboard[p.name] = unitsOf(p);
+
             showLeaderboard(leaderboard);
             break;
         }
+        else if (choice == 9) {
+            // Undocumented balance-rig hook: fast-forward N seconds of
+            // idle play through the closed-form simulator
+            long long seconds;
+            cout << "Fast-forward seconds: ";
+            cin >> seconds;
+            simulateTicks(p, max(0LL, seconds));
+        }
         else {
             cout << "Invalid choice.\n";
         }
@@ -261,5 +851,9 @@ int main() {
 
     // Detach thread to allow clean exit
     idleThread.detach();
+
+    if (prof::enabled())
+        prof::dump("hoard_profile.csv");
+
     return 0;
 }
@@ -6,17 +6,39 @@
 #include <vector>
 #include <random>
 
-// Game configuration constants
-// Centralized for easy tuning of game balance
-const unsigned int WIN_WIDTH = 1200;
-const unsigned int WIN_HEIGHT = 800;
-const int WIN_SCORE = 100;
-const float PLAYER_SPEED = 400.f;
-const size_t MAX_PARTICLES = 50;
-
-// Encapsulates all entity state: visuals, physics, and input mapping
+#include "../Common/profiler.hpp"
+#include "../Common/scenario.hpp"
+
+// Game configuration
+// Centralized for easy tuning of game balance; these five can also be
+// overridden at startup by a --scenario file (see Common/scenario.hpp)
+unsigned int WIN_WIDTH = 1200;
+unsigned int WIN_HEIGHT = 800;
+int WIN_SCORE = 100;
+float PLAYER_SPEED = 400.f;
+size_t MAX_PARTICLES = 50;
+const float PARTICLE_RADIUS = 4.f;
+
+// Fixed simulation timestep: gameplay advances in deterministic 120Hz
+// ticks regardless of display refresh rate, so movement and collision
+// outcomes no longer depend on frame pacing. Rendering interpolates
+// between the last two ticks for smoothness.
+const float FIXED_DT = 1.f / 120.f;
+// Cap on frame time fed to the accumulator so a stall (window drag,
+// debugger break) doesn't trigger a catch-up spiral of ticks
+const float MAX_FRAME_TIME = 0.25f;
+// 1% per frame at the old ~60fps cadence becomes 0.5% per 120Hz tick,
+// preserving the expected spawn rate
+const float SPAWN_CHANCE_PER_TICK = 0.005f;
+
+// Encapsulates all entity state: visuals, physics, and input mapping.
+// Physics position lives in pos/prevPos (current and previous tick);
+// the shape is purely visual and is placed at an interpolated position
+// each frame by the render phase.
 struct Player {
     sf::CircleShape shape;
+    sf::Vector2f pos{ 0.f, 0.f };
+    sf::Vector2f prevPos{ 0.f, 0.f };
     sf::Vector2f velocity{ 0.f, 0.f };
     float speed;
     int score = 0;
@@ -27,7 +49,7 @@ struct Player {
     } keys;
 
     Player(sf::Color color, sf::Vector2f startPos, float moveSpeed, Controls c)
-        : speed(moveSpeed), keys(c)
+        : pos(startPos), prevPos(startPos), speed(moveSpeed), keys(c)
     {
         shape.setRadius(15.f);
         shape.setOrigin({ 15.f, 15.f });
@@ -35,6 +57,14 @@ struct Player {
         shape.setPosition(startPos);
     }
 
+    // Teleport without leaving an interpolation streak (used on restart)
+    void setPosition(sf::Vector2f p) {
+        pos = prevPos = p;
+        shape.setPosition(p);
+    }
+
+    float radius() const { return shape.getRadius(); }
+
     // Polling-based input handling for smooth continuous movement
     void handleInput() {
         velocity = { 0.f, 0.f };
@@ -44,25 +74,104 @@ struct Player {
         if (sf::Keyboard::isKeyPressed(keys.right)) velocity.x += speed;
     }
 
-    // Integration step: updates position based on velocity * deltaTime
+    // Integration step: one fixed tick of velocity * dt
     // Includes boundary checks to clamp player within window limits
     void move(float dt, sf::Vector2u winSize) {
-        sf::Vector2f pos = shape.getPosition() + velocity * dt;
+        prevPos = pos;
+        pos += velocity * dt;
         float r = shape.getRadius();
         pos.x = std::clamp(pos.x, r, static_cast<float>(winSize.x) - r);
         pos.y = std::clamp(pos.y, r, static_cast<float>(winSize.y) - r);
-        shape.setPosition(pos);
+    }
+
+    // Places the visual shape between the last two ticks; alpha is the
+    // fraction of the next tick already accumulated
+    void updateVisual(float alpha) {
+        shape.setPosition(prevPos + (pos - prevPos) * alpha);
     }
 };
 
+// Slimmed to plain position data: every particle shares the same circle
+// geometry, which exists exactly once in the batched renderer below
+// instead of per-particle sf::CircleShape vertex lists and transforms.
 struct Particle {
-    sf::CircleShape shape;
-    Particle(sf::Vector2f pos) {
-        shape.setRadius(4.f);
-        shape.setOrigin({ 4.f, 4.f });
-        shape.setFillColor(sf::Color::White);
-        shape.setPosition(pos);
+    sf::Vector2f pos;
+};
+
+// Batched particle renderer: all particles are emitted into one
+// contiguous vertex buffer and issued as a single draw call per frame,
+// removing the per-shape draw-call overhead that caps frame rate at
+// high particle counts. The circle is approximated by a small
+// precomputed triangle fan — at 4px radius, 8 segments are
+// indistinguishable from sf::CircleShape's tessellation.
+class ParticleRenderer {
+public:
+    ParticleRenderer() {
+        // Unit-circle rim offsets, computed once
+        for (int i = 0; i <= SEGMENTS; ++i) {
+            float angle = static_cast<float>(i) / SEGMENTS * 6.2831853f;
+            rim[i] = { std::cos(angle), std::sin(angle) };
+        }
+        vertices.reserve(MAX_PARTICLES * SEGMENTS * 3);
+    }
+
+    void draw(sf::RenderWindow& window, const std::vector<Particle>& particles) {
+        PROF_ZONE("particles.draw");
+        vertices.clear(); // capacity retained; no per-frame allocation
+
+        for (const auto& p : particles) {
+            for (int i = 0; i < SEGMENTS; ++i) {
+                vertices.push_back({ p.pos, sf::Color::White, {} });
+                vertices.push_back({ p.pos + rim[i] * PARTICLE_RADIUS,
+                    sf::Color::White, {} });
+                vertices.push_back({ p.pos + rim[i + 1] * PARTICLE_RADIUS,
+                    sf::Color::White, {} });
+            }
+        }
+
+        if (!vertices.empty())
+            window.draw(vertices.data(), vertices.size(),
+                sf::PrimitiveType::Triangles);
+    }
+
+private:
+    static const int SEGMENTS = 8;
+    sf::Vector2f rim[SEGMENTS + 1];
+    std::vector<sf::Vertex> vertices;
+};
+
+// Round-robin pool of pre-initialized sound voices sharing one buffer.
+// A single sf::Sound cuts itself off when retriggered while still
+// playing (both players grabbing pickups in the same tick), and
+// constructing voices on demand pays backend channel setup inside the
+// game loop. The pool allocates and warms every voice at startup, then
+// play() just rotates through them.
+class SoundPool {
+public:
+    SoundPool(const sf::SoundBuffer& buffer, float volume) {
+        voices.reserve(VOICES);
+        for (int i = 0; i < VOICES; ++i) {
+            voices.emplace_back(buffer);
+            // Warm-up: trigger each voice muted once so the audio
+            // backend binds its channel before gameplay starts
+            voices.back().setVolume(0.f);
+            voices.back().play();
+            voices.back().stop();
+            voices.back().setVolume(volume);
+        }
     }
+
+    void play() {
+        voices[next].play();
+        next = (next + 1) % VOICES;
+    }
+
+private:
+    // Enough voices that a full rotation outlasts one pickup blip even
+    // with both players collecting every tick
+    static const int VOICES = 8;
+    std::vector<sf::Sound> voices;
+    int next = 0;
 };
 
 // Optimized collision detection
@@ -75,7 +184,99 @@ bool checkCollision(const sf::Vector2f& a, float ra, const sf::Vector2f& b, floa
     return d <= r * r;
 }
 
-int main() {
+// Uniform spatial hash grid broad-phase for particle collisions.
+// Particles never move once spawned, so the grid is maintained
+// incrementally — one insert per spawn, one remove (plus an index fixup
+// for the swap-and-popped particle) per pickup — instead of being rebuilt.
+// A player then only tests particles in its 3x3 cell neighborhood,
+// turning the O(players * N) scan into O(players * k).
+class SpatialGrid {
+public:
+    // Cell size must be at least the largest query radius
+    // (player radius + particle radius) so a 3x3 neighborhood suffices
+    void init(sf::Vector2u size, float cell) {
+        cellSize = cell;
+        cols = static_cast<int>(size.x / cell) + 1;
+        rows = static_cast<int>(size.y / cell) + 1;
+        cells.assign(static_cast<size_t>(cols) * rows, {});
+    }
+
+    void clear() {
+        for (auto& c : cells) c.clear();
+    }
+
+    void insert(int idx, sf::Vector2f pos) {
+        cells[cellOf(pos)].push_back(idx);
+    }
+
+    // Swap-and-pop within the cell; particle counts per cell are tiny
+    void remove(int idx, sf::Vector2f pos) {
+        auto& cell = cells[cellOf(pos)];
+        for (size_t i = 0; i < cell.size(); ++i) {
+            if (cell[i] == idx) {
+                cell[i] = cell.back();
+                cell.pop_back();
+                return;
+            }
+        }
+    }
+
+    // After the particle vector swap-and-pops, the moved particle's
+    // index changes; patch it in place
+    void reindex(int oldIdx, int newIdx, sf::Vector2f pos) {
+        auto& cell = cells[cellOf(pos)];
+        for (int& stored : cell) {
+            if (stored == oldIdx) {
+                stored = newIdx;
+                return;
+            }
+        }
+    }
+
+    // Visits every particle index in the 3x3 neighborhood around pos
+    template <typename Visitor>
+    void forEachNear(sf::Vector2f pos, Visitor&& visit) const {
+        int cx = std::clamp(static_cast<int>(pos.x / cellSize), 0, cols - 1);
+        int cy = std::clamp(static_cast<int>(pos.y / cellSize), 0, rows - 1);
+
+        for (int y = std::max(0, cy - 1); y <= std::min(rows - 1, cy + 1); ++y)
+            for (int x = std::max(0, cx - 1); x <= std::min(cols - 1, cx + 1); ++x)
+                for (int idx : cells[static_cast<size_t>(y) * cols + x])
+                    visit(idx);
+    }
+
+private:
+    size_t cellOf(sf::Vector2f pos) const {
+        int cx = std::clamp(static_cast<int>(pos.x / cellSize), 0, cols - 1);
+        int cy = std::clamp(static_cast<int>(pos.y / cellSize), 0, rows - 1);
+        return static_cast<size_t>(cy) * cols + cx;
+    }
+
+    float cellSize = 64.f;
+    int cols = 0, rows = 0;
+    std::vector<std::vector<int>> cells;
+};
+
+int main(int argc, char** argv) {
+    // Usage: Munch [--scenario <file>]
+    // A scenario overrides the arena configuration before any of it is
+    // consumed (window, reserves, spawn bounds)
+    for (int i = 1; i < argc; i++) {
+        if (std::string(argv[i]) == "--scenario" && i + 1 < argc) {
+            scn::Scenario s;
+            std::string err;
+            if (!scn::load(argv[++i], s, err)) {
+                std::fprintf(stderr, "%s\n", err.c_str());
+                return EXIT_FAILURE;
+            }
+            WIN_WIDTH = s.winWidth;
+            WIN_HEIGHT = s.winHeight;
+            WIN_SCORE = s.winScore;
+            PLAYER_SPEED = s.playerSpeed;
+            MAX_PARTICLES = s.maxParticles;
+        }
+    }
+
     // Window setup with VSync enabled to prevent screen tearing
     sf::RenderWindow window(sf::VideoMode({ WIN_WIDTH, WIN_HEIGHT }), "Munch");
     window.setVerticalSyncEnabled(true);
@@ -89,9 +290,8 @@ int main() {
     if (!pickupBuf.loadFromFile("pickup.wav")) return EXIT_FAILURE;
     if (!winBuf.loadFromFile("win.wav")) return EXIT_FAILURE;
 
-    sf::Sound pickupSound(pickupBuf);
+    SoundPool pickupVoices(pickupBuf, 60.f);
     sf::Sound winSound(winBuf);
-    pickupSound.setVolume(60.f);
     winSound.setVolume(80.f);
 
     // UI Initialization
@@ -112,6 +312,12 @@ int main() {
     winText.setCharacterSize(60);
     winText.setStyle(sf::Text::Bold);
 
+    // Frame-timing overlay (F3); populated from the profiler per frame
+    sf::Text overlayText(font);
+    overlayText.setCharacterSize(14);
+    overlayText.setFillColor(sf::Color::Green);
+    overlayText.setPosition({ 20.f, 60.f });
+
     // Instantiate Players with distinct controls
     Player p1(sf::Color::Blue, { 100.f, WIN_HEIGHT / 2.f }, PLAYER_SPEED,
         { sf::Keyboard::Key::W, sf::Keyboard::Key::S, sf::Keyboard::Key::A, sf::Keyboard::Key::D });
@@ -122,6 +328,15 @@ int main() {
     // Pre-allocate vector memory to avoid reallocation during gameplay
     std::vector<Particle> particles;
     particles.reserve(MAX_PARTICLES);
+    ParticleRenderer particleRenderer;
+
+    // Broad-phase grid: 64px cells comfortably cover the player+particle
+    // query radius with a 3x3 neighborhood
+    SpatialGrid grid;
+    grid.init(window.getSize(), 64.f);
+
+    std::vector<int> collected; // pickup indices gathered per frame
+    collected.reserve(16);
 
     // Mersenne Twister RNG for high-quality random distribution
     std::mt19937 rng(std::random_device{}());
@@ -130,6 +345,7 @@ int main() {
     std::uniform_real_distribution<float> spawnChance(0.f, 1.f);
 
     sf::Clock clock;
+    float accumulator = 0.f;
     bool gameOver = false;
     bool dirtyScore = false; // Flag to minimize expensive text string updates
 
@@ -139,37 +355,61 @@ int main() {
         while (const auto event = window.pollEvent()) {
             if (event->is<sf::Event::Closed>()) window.close();
 
+            // F3 toggles the frame-timing overlay
+            if (event->is<sf::Event::KeyPressed>() &&
+                event->getIf<sf::Event::KeyPressed>()->code == sf::Keyboard::Key::F3) {
+                prof::setEnabled(!prof::enabled());
+            }
+
             // Restart Logic
             if (gameOver && event->is<sf::Event::KeyPressed>()) {
                 if (event->getIf<sf::Event::KeyPressed>()->code == sf::Keyboard::Key::Space) {
                     p1.score = 0;
                     p2.score = 0;
-                    p1.shape.setPosition({ 100.f, WIN_HEIGHT / 2.f });
-                    p2.shape.setPosition({ WIN_WIDTH - 100.f, WIN_HEIGHT / 2.f });
+                    p1.setPosition({ 100.f, WIN_HEIGHT / 2.f });
+                    p2.setPosition({ WIN_WIDTH - 100.f, WIN_HEIGHT / 2.f });
                     particles.clear();
+                    grid.clear();
                     dirtyScore = true;
                     gameOver = false;
                 }
             }
         }
 
-        // Calculate Delta Time (dt) to ensure frame-rate independent movement
-        float dt = std::min(clock.restart().asSeconds(), 0.1f);
+        // Feed elapsed wall time into the accumulator; the simulation
+        // then advances in whole fixed ticks and carries the remainder
+        // into the next frame
+        float frameTime = std::min(clock.restart().asSeconds(), MAX_FRAME_TIME);
 
         if (!gameOver) {
-            // Spawn Logic: 1% chance per frame if under capacity
-            if (particles.size() < MAX_PARTICLES && spawnChance(rng) < 0.01f)
-                particles.emplace_back(sf::Vector2f{ xDist(rng), yDist(rng) });
+            accumulator += frameTime;
 
-            // Physics Update
+            // Input is polled once per frame; within a frame every tick
+            // sees the same key state anyway
             p1.handleInput();
             p2.handleInput();
-            p1.move(dt, window.getSize());
-            p2.move(dt, window.getSize());
+        }
+        else {
+            accumulator = 0.f;
+        }
+
+        while (!gameOver && accumulator >= FIXED_DT) {
+            PROF_ZONE("sim.tick");
+            accumulator -= FIXED_DT;
+
+            // Spawn Logic: fixed chance per tick if under capacity
+            if (particles.size() < MAX_PARTICLES && spawnChance(rng) < SPAWN_CHANCE_PER_TICK) {
+                sf::Vector2f pos{ xDist(rng), yDist(rng) };
+                particles.push_back({ pos });
+                grid.insert(static_cast<int>(particles.size()) - 1, pos);
+            }
+
+            // Physics Update
+            p1.move(FIXED_DT, window.getSize());
+            p2.move(FIXED_DT, window.getSize());
 
             // Player-vs-Player Collision (Game Over Condition)
-            if (checkCollision(p1.shape.getPosition(), p1.shape.getRadius(),
-                p2.shape.getPosition(), p2.shape.getRadius())) {
+            if (checkCollision(p1.pos, p1.radius(), p2.pos, p2.radius())) {
                 gameOver = true;
                 winSound.play();
                 
@@ -189,33 +429,48 @@ int main() {
             }
 
             // Player-vs-Particle Collision
-            for (size_t i = 0; i < particles.size(); ) {
-                bool collected = false;
-                sf::Vector2f pos = particles[i].shape.getPosition();
-                float r = particles[i].shape.getRadius();
-
-                if (checkCollision(p1.shape.getPosition(), p1.shape.getRadius(), pos, r)) {
-                    p1.score++;
-                    collected = true;
-                }
-                else if (checkCollision(p2.shape.getPosition(), p2.shape.getRadius(), pos, r)) {
-                    p2.score++;
-                    collected = true;
-                }
+            // Broad-phase: each player only narrow-tests particles from
+            // its grid neighborhood, not the whole arena
+            collected.clear();
+
+            auto gatherPickups = [&](Player& pl) {
+                grid.forEachNear(pl.pos, [&](int idx) {
+                    // P1 is gathered first and wins contested particles
+                    for (int c : collected)
+                        if (c == idx) return;
+
+                    if (checkCollision(pl.pos, pl.radius(),
+                        particles[idx].pos, PARTICLE_RADIUS)) {
+                        pl.score++;
+                        pickupVoices.play();
+                        dirtyScore = true;
+                        collected.push_back(idx);
+                    }
+                    });
+                };
+            gatherPickups(p1);
+            gatherPickups(p2);
+
+            if (!collected.empty()) {
+                // Remove highest indices first so the remaining indices
+                // stay valid through each swap-and-pop
+                std::sort(collected.begin(), collected.end(),
+                    [](int a, int b) { return a > b; });
+
+                for (int idx : collected) {
+                    grid.remove(idx, particles[idx].pos);
 
-                if (collected) {
-                    pickupSound.play();
-                    dirtyScore = true;
-                    
                     // Optimization: Swap-and-Pop
-                    // Replaces the collected particle with the last one and shrinks vector.
-                    // This is O(1) compared to O(n) for erasing from the middle.
-                    particles[i] = particles.back();
+                    // Replaces the collected particle with the last one and
+                    // shrinks the vector: O(1) vs O(n) middle erase. The
+                    // moved particle's grid entry is patched to its new index.
+                    int last = static_cast<int>(particles.size()) - 1;
+                    if (idx != last) {
+                        grid.reindex(last, idx, particles[last].pos);
+                        particles[idx] = particles.back();
+                    }
                     particles.pop_back();
                 }
-                else {
-                    ++i;
-                }
             }
 
             // Score limit check
@@ -253,13 +508,29 @@ int main() {
         }
 
         // Render Phase
-        window.clear();
-        for (const auto& p : particles) window.draw(p.shape);
-        window.draw(p1.shape);
-        window.draw(p2.shape);
-        window.draw(scoreP1);
-        window.draw(scoreP2);
-        if (gameOver) window.draw(winText);
+        // Draw players at a position interpolated between the last two
+        // ticks; the leftover accumulator fraction is the blend factor
+        float alpha = gameOver ? 1.f : accumulator / FIXED_DT;
+        p1.updateVisual(alpha);
+        p2.updateVisual(alpha);
+
+        {
+            PROF_ZONE("frame.render");
+            window.clear();
+            particleRenderer.draw(window, particles);
+            window.draw(p1.shape);
+            window.draw(p2.shape);
+            window.draw(scoreP1);
+            window.draw(scoreP2);
+            if (gameOver) window.draw(winText);
+
+            if (prof::enabled()) {
+                overlayText.setString(prof::overlayText());
+                window.draw(overlayText);
+            }
+        }
         window.display();
     }
+
+    if (prof::enabled()) prof::dump("munch_profile.csv");
 }
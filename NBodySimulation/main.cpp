@@ -3,10 +3,43 @@
 #include <SFML/Graphics.hpp>
 #include <string>
 #include <cmath>
+#include <algorithm>
 #include <optional>
-#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <chrono>
+#include <random>
+#include <fstream>
+#include <filesystem>
+#include <cstdint>
+#include <cstring>
+#include <cstdlib>
 #include <corecrt_math_defines.h>
 
+#include "../Common/profiler.hpp"
+#include "../Common/scenario.hpp"
+
+// Memory mapping for trajectory replay (platform-specific)
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// SIMD force kernel: enabled when the compiler targets AVX2
+// (MSVC: /arch:AVX2, GCC/Clang: -mavx2). A scalar fallback below keeps the
+// build portable.
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
 // Physics Constants
 // G is normalized to 4*PI^2 so that:
 // Mass is in Solar Masses, Distance in AU (Astronomical Units), Time in Years.
@@ -42,69 +75,725 @@ inline double norm(const Vec3& v) {
     return std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z);
 }
 
-struct Body {
-    double mass;
-    Vec3 position;
-    Vec3 velocity;
-    Vec3 acceleration;
+// Structure-of-Arrays physics state.
+// Each attribute lives in its own contiguous array so the force loop streams
+// exactly the doubles it needs — no render state polluting the cache lines.
+// Components are split (x/y/z as separate arrays) to keep the layout
+// vectorization-friendly.
+struct PhysicsState {
+    std::vector<double> mass;
+    std::vector<double> posX, posY, posZ;
+    std::vector<double> velX, velY, velZ;
+    std::vector<double> accX, accY, accZ;
+
+    size_t count() const { return mass.size(); }
+
+    void add(double m, const Vec3& pos, const Vec3& vel) {
+        mass.push_back(m);
+        posX.push_back(pos.x); posY.push_back(pos.y); posZ.push_back(pos.z);
+        velX.push_back(vel.x); velY.push_back(vel.y); velZ.push_back(vel.z);
+        accX.push_back(0.0); accY.push_back(0.0); accZ.push_back(0.0);
+    }
+
+    Vec3 position(size_t i) const { return { posX[i], posY[i], posZ[i] }; }
+};
+
+// Render-only attributes, parallel to PhysicsState by index.
+// Touched exclusively in the draw phase.
+struct BodyVisual {
     sf::CircleShape shape;
-    // Deque used for trails to allow efficient removal from the front (oldest points)
-    std::deque<sf::Vector2f> trail;
 };
 
-// N-Body Force Calculation: O(N^2) complexity
+// Fixed-capacity ring-buffer trail storage with a single batched draw.
+// Trail points for all bodies live in one contiguous slab (body-major
+// rings), so pushing a point is one write into preallocated memory — no
+// deque nodes scattered across the heap. Each frame the trail segments of
+// every body are emitted into one persistent vertex buffer and issued as a
+// single draw call instead of one sf::VertexArray allocation per body.
+class TrailRenderer {
+public:
+    void init(size_t bodies, size_t cap) {
+        capacity = cap;
+        points.assign(bodies * cap, sf::Vector2f{});
+        head.assign(bodies, 0);
+        length.assign(bodies, 0);
+        colors.assign(bodies, sf::Color::White);
+        vertices.reserve(bodies * cap * 2);
+    }
+
+    void setColor(size_t body, sf::Color c) { colors[body] = c; }
+
+    // O(1): overwrite the oldest slot of the body's ring
+    void push(size_t body, sf::Vector2f p) {
+        points[body * capacity + head[body]] = p;
+        head[body] = (head[body] + 1) % capacity;
+        if (length[body] < capacity)
+            ++length[body];
+    }
+
+    void draw(sf::RenderWindow& window) {
+        PROF_ZONE("trails.draw");
+        vertices.clear(); // capacity is retained; no reallocation after warm-up
+
+        for (size_t b = 0; b < head.size(); ++b) {
+            size_t len = length[b];
+            if (len < 2)
+                continue;
+
+            const sf::Vector2f* ring = &points[b * capacity];
+            sf::Color c = colors[b];
+            float invLen = 1.f / static_cast<float>(len);
+
+            // Walk from the oldest point towards the head, fading alpha in
+            // (older segments = more transparent)
+            size_t idx = (head[b] + capacity - len) % capacity;
+            sf::Vector2f prev = ring[idx];
+
+            for (size_t k = 1; k < len; ++k) {
+                idx = idx + 1 == capacity ? 0 : idx + 1;
+                sf::Vector2f cur = ring[idx];
+
+                sf::Color faded(c.r, c.g, c.b,
+                    static_cast<std::uint8_t>(255.f * k * invLen));
+                vertices.push_back({ prev, faded, {} });
+                vertices.push_back({ cur, faded, {} });
+                prev = cur;
+            }
+        }
+
+        if (!vertices.empty())
+            window.draw(vertices.data(), vertices.size(),
+                sf::PrimitiveType::Lines);
+    }
+
+private:
+    size_t capacity = 0;
+    std::vector<sf::Vector2f> points; // bodyCount * capacity ring slots
+    std::vector<size_t> head;         // next write slot per body
+    std::vector<size_t> length;       // valid points per body
+    std::vector<sf::Color> colors;    // cached fill color per body
+    std::vector<sf::Vertex> vertices; // persistent batch buffer
+};
+
+// Persistent worker pool for the force stage.
+// Threads are created once and sleep between jobs; work is handed out in
+// fixed-size tiles through an atomic cursor so uneven rows (the pair space
+// is triangular) stay load-balanced. The caller's thread participates as
+// worker 0, so a pool on an H-core machine runs H-wide.
+class ThreadPool {
+public:
+    static ThreadPool& instance() {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    size_t threadCount() const { return workers.size() + 1; }
+
+    // Runs fn(threadIndex, begin, end) over [0, count) in tiles of `tile`.
+    void run(size_t count, size_t tile,
+        const std::function<void(size_t, size_t, size_t)>& fn) {
+        if (count == 0) return;
+        if (workers.empty()) {
+            fn(0, 0, count);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job = &fn;
+            jobCount = count;
+            jobTile = std::max<size_t>(1, tile);
+            cursor.store(0, std::memory_order_relaxed);
+            pending = workers.size();
+            ++generation;
+        }
+        wakeCv.notify_all();
+
+        drain(0);
+
+        std::unique_lock<std::mutex> lock(mutex);
+        doneCv.wait(lock, [this] { return pending == 0; });
+        job = nullptr;
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+private:
+    ThreadPool() {
+        unsigned hw = std::thread::hardware_concurrency();
+        size_t extra = hw > 1 ? hw - 1 : 0;
+        for (size_t t = 0; t < extra; ++t)
+            workers.emplace_back([this, t] { workerLoop(t + 1); });
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wakeCv.notify_all();
+        for (auto& w : workers)
+            w.join();
+    }
+
+    // Pulls tiles off the shared cursor until the range is exhausted
+    void drain(size_t threadIdx) {
+        const auto* fn = job;
+        while (true) {
+            size_t begin = cursor.fetch_add(jobTile, std::memory_order_relaxed);
+            if (begin >= jobCount)
+                break;
+            (*fn)(threadIdx, begin, std::min(begin + jobTile, jobCount));
+        }
+    }
+
+    void workerLoop(size_t threadIdx) {
+        size_t seen = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wakeCv.wait(lock, [&] { return stopping || generation != seen; });
+                if (stopping)
+                    return;
+                seen = generation;
+            }
+
+            drain(threadIdx);
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                --pending;
+            }
+            doneCv.notify_one();
+        }
+    }
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wakeCv, doneCv;
+    const std::function<void(size_t, size_t, size_t)>* job = nullptr;
+    size_t jobCount = 0, jobTile = 1;
+    std::atomic<size_t> cursor{ 0 };
+    size_t pending = 0;
+    size_t generation = 0;
+    bool stopping = false;
+};
+
+// Scenes below this body count run the force stage single-threaded;
+// pool hand-off costs more than it saves on tiny scenes.
+const size_t PARALLEL_THRESHOLD = 1024;
+
+// Rows of the pair space handed out per tile
+const size_t FORCE_TILE_ROWS = 32;
+
+// Scalar pair interaction, shared by the portable path and the SIMD tail.
+// Newton's Law of Universal Gravitation: F = G * m1 * m2 / r^2
+// Vector form: F_vec = F * (r_vec / r)
+// Accumulates into caller-provided arrays so parallel callers can hand in
+// per-thread buffers (keeping the action-reaction write race-free).
+inline void applyPairForce(const PhysicsState& s, size_t i, size_t j,
+    double* ax, double* ay, double* az) {
+    double rx = s.posX[j] - s.posX[i];
+    double ry = s.posY[j] - s.posY[i];
+    double rz = s.posZ[j] - s.posZ[i];
+
+    double dist = std::sqrt(rx * rx + ry * ry + rz * rz) + EPS;
+    double invDist3 = 1.0 / (dist * dist * dist);
+    double f = G * invDist3;
+
+    // Apply forces (Action-Reaction pair)
+    ax[i] += s.mass[j] * f * rx;
+    ay[i] += s.mass[j] * f * ry;
+    az[i] += s.mass[j] * f * rz;
+
+    ax[j] -= s.mass[i] * f * rx;
+    ay[j] -= s.mass[i] * f * ry;
+    az[j] -= s.mass[i] * f * rz;
+}
+
+#if defined(__AVX2__)
+// Horizontal sum of the 4 lanes of a 256-bit double vector
+inline double hsum(__m256d v) {
+    __m128d lo = _mm256_castpd256_pd128(v);
+    __m128d hi = _mm256_extractf128_pd(v, 1);
+    lo = _mm_add_pd(lo, hi);
+    return _mm_cvtsd_f64(_mm_add_sd(lo, _mm_unpackhi_pd(lo, lo)));
+}
+#endif
+
+// One row of the pair space: all interactions (i, j > i), accumulated into
+// the provided arrays.
+//
+// With AVX2 the inner loop processes 4 j-bodies per iteration: one distance
+// computation, one inverse-cube, and both halves of the action-reaction
+// update are done on 4 pairs at once. Lanes never alias because j > i.
+void forceRow(const PhysicsState& s, size_t rowBegin, size_t rowEnd,
+    double* outAccX, double* outAccY, double* outAccZ) {
+    const size_t n = s.count();
+
+#if defined(__AVX2__)
+    const __m256d vG = _mm256_set1_pd(G);
+    const __m256d vEPS = _mm256_set1_pd(EPS);
+    const __m256d vOne = _mm256_set1_pd(1.0);
+
+    for (size_t i = rowBegin; i < rowEnd; ++i) {
+        const __m256d pix = _mm256_set1_pd(s.posX[i]);
+        const __m256d piy = _mm256_set1_pd(s.posY[i]);
+        const __m256d piz = _mm256_set1_pd(s.posZ[i]);
+        const __m256d mi = _mm256_set1_pd(s.mass[i]);
+
+        // Per-lane accumulators for body i, reduced once after the loop
+        __m256d aix = _mm256_setzero_pd();
+        __m256d aiy = _mm256_setzero_pd();
+        __m256d aiz = _mm256_setzero_pd();
+
+        size_t j = i + 1;
+        for (; j + 4 <= n; j += 4) {
+            __m256d rx = _mm256_sub_pd(_mm256_loadu_pd(&s.posX[j]), pix);
+            __m256d ry = _mm256_sub_pd(_mm256_loadu_pd(&s.posY[j]), piy);
+            __m256d rz = _mm256_sub_pd(_mm256_loadu_pd(&s.posZ[j]), piz);
+
+            __m256d d2 = _mm256_add_pd(
+                _mm256_add_pd(_mm256_mul_pd(rx, rx), _mm256_mul_pd(ry, ry)),
+                _mm256_mul_pd(rz, rz));
+
+            __m256d dist = _mm256_add_pd(_mm256_sqrt_pd(d2), vEPS);
+            __m256d invDist3 = _mm256_div_pd(vOne,
+                _mm256_mul_pd(_mm256_mul_pd(dist, dist), dist));
+
+            __m256d f = _mm256_mul_pd(vG, invDist3);
+            __m256d mj = _mm256_loadu_pd(&s.mass[j]);
+
+            __m256d fmj = _mm256_mul_pd(f, mj);
+            aix = _mm256_add_pd(aix, _mm256_mul_pd(fmj, rx));
+            aiy = _mm256_add_pd(aiy, _mm256_mul_pd(fmj, ry));
+            aiz = _mm256_add_pd(aiz, _mm256_mul_pd(fmj, rz));
+
+            // Reaction: subtract from the 4 j-bodies in place
+            __m256d fmi = _mm256_mul_pd(f, mi);
+            _mm256_storeu_pd(&outAccX[j], _mm256_sub_pd(
+                _mm256_loadu_pd(&outAccX[j]), _mm256_mul_pd(fmi, rx)));
+            _mm256_storeu_pd(&outAccY[j], _mm256_sub_pd(
+                _mm256_loadu_pd(&outAccY[j]), _mm256_mul_pd(fmi, ry)));
+            _mm256_storeu_pd(&outAccZ[j], _mm256_sub_pd(
+                _mm256_loadu_pd(&outAccZ[j]), _mm256_mul_pd(fmi, rz)));
+        }
+
+        outAccX[i] += hsum(aix);
+        outAccY[i] += hsum(aiy);
+        outAccZ[i] += hsum(aiz);
+
+        // Remaining (< 4) pairs handled by the scalar kernel
+        for (; j < n; ++j)
+            applyPairForce(s, i, j, outAccX, outAccY, outAccZ);
+    }
+#else
+    for (size_t i = rowBegin; i < rowEnd; ++i)
+        for (size_t j = i + 1; j < n; ++j)
+            applyPairForce(s, i, j, outAccX, outAccY, outAccZ);
+#endif
+}
+
+// Direct-Sum Force Calculation: O(N^2) complexity
 // Computes gravitational force between every pair of bodies.
-void computeAccelerations(std::vector<Body>& bodies) {
+// Exact result; used for small scenes where N^2 is affordable.
+//
+// Large scenes tile the rows of the pair space across the thread pool.
+// Each thread accumulates into its own full-length buffers (the Newton's
+// third law write to body j would otherwise race across tiles); buffers are
+// summed into the state in a parallel reduction afterwards.
+void computeAccelerationsDirect(PhysicsState& s) {
+    PROF_ZONE("accel.direct");
+    const size_t n = s.count();
+
     // Reset accelerations
-    for (auto& b : bodies)
-        b.acceleration = { 0,0,0 };
+    std::fill(s.accX.begin(), s.accX.end(), 0.0);
+    std::fill(s.accY.begin(), s.accY.end(), 0.0);
+    std::fill(s.accZ.begin(), s.accZ.end(), 0.0);
+
+    ThreadPool& pool = ThreadPool::instance();
+
+    if (n < PARALLEL_THRESHOLD || pool.threadCount() == 1) {
+        forceRow(s, 0, n, s.accX.data(), s.accY.data(), s.accZ.data());
+        return;
+    }
+
+    // Per-thread accumulator buffers, kept across calls to avoid reallocation
+    static std::vector<std::vector<double>> scratch;
+    const size_t threads = pool.threadCount();
+    scratch.resize(threads * 3);
+    for (auto& buf : scratch)
+        buf.assign(n, 0.0);
+
+    pool.run(n, FORCE_TILE_ROWS,
+        [&](size_t tid, size_t begin, size_t end) {
+            forceRow(s, begin, end,
+                scratch[tid * 3 + 0].data(),
+                scratch[tid * 3 + 1].data(),
+                scratch[tid * 3 + 2].data());
+        });
+
+    // Reduction: sum the per-thread buffers, parallel over body index
+    pool.run(n, 4096,
+        [&](size_t, size_t begin, size_t end) {
+            for (size_t t = 0; t < threads; ++t) {
+                const double* bx = scratch[t * 3 + 0].data();
+                const double* by = scratch[t * 3 + 1].data();
+                const double* bz = scratch[t * 3 + 2].data();
+                for (size_t i = begin; i < end; ++i) {
+                    s.accX[i] += bx[i];
+                    s.accY[i] += by[i];
+                    s.accZ[i] += bz[i];
+                }
+            }
+        });
+}
+
+// Barnes-Hut Approximation: O(N log N) complexity
+// Bodies are sorted into an octree; distant clusters are treated as a single
+// point mass at their center of mass. THETA controls the accuracy/speed
+// trade-off: a cell of size s at distance d is used whole when s/d < THETA.
+const double THETA = 0.5;
+
+// Scenes at or above this body count switch from direct sum to Barnes-Hut.
+// Small scenes (like the solar system) keep the exact pairwise result.
+const size_t BARNES_HUT_THRESHOLD = 256;
+
+struct OctreeNode {
+    Vec3 center{ 0,0,0 };      // Geometric center of this cell
+    double halfSize = 0.0;     // Half the cell's edge length
+    Vec3 centerOfMass{ 0,0,0 };
+    double mass = 0.0;
+    int firstChild = -1;       // Index of first of 8 contiguous children (-1 = leaf)
+    int bodyIndex = -1;        // Body held by a leaf (-1 = empty leaf)
+};
 
-    for (size_t i = 0; i < bodies.size(); ++i) {
-        for (size_t j = i + 1; j < bodies.size(); ++j) {
-            Vec3 r = bodies[j].position - bodies[i].position;
+class Octree {
+public:
+    // Rebuilds the tree from scratch each step. Node storage is a flat
+    // vector reused across calls, so steady-state builds do not allocate.
+    void build(const PhysicsState& s) {
+        nodes.clear();
 
+        // Root cell: cube bounding every body
+        Vec3 lo = s.position(0), hi = s.position(0);
+        for (size_t i = 0; i < s.count(); ++i) {
+            lo.x = std::min(lo.x, s.posX[i]); hi.x = std::max(hi.x, s.posX[i]);
+            lo.y = std::min(lo.y, s.posY[i]); hi.y = std::max(hi.y, s.posY[i]);
+            lo.z = std::min(lo.z, s.posZ[i]); hi.z = std::max(hi.z, s.posZ[i]);
+        }
+
+        OctreeNode root;
+        root.center = (lo + hi) * 0.5;
+        root.halfSize = 0.5 * std::max({ hi.x - lo.x, hi.y - lo.y, hi.z - lo.z }) + EPS;
+        nodes.push_back(root);
+
+        for (int i = 0; i < static_cast<int>(s.count()); ++i)
+            insert(0, i, s);
+
+        computeMassDistribution(0, s);
+    }
+
+    // Accumulates the gravitational acceleration on one body by walking the
+    // tree with an explicit stack (avoids recursion overhead in the hot path).
+    Vec3 accelerationOn(size_t bodyIdx, const PhysicsState& s) const {
+        Vec3 p = s.position(bodyIdx);
+        Vec3 acc{ 0,0,0 };
+
+        static thread_local std::vector<int> stack;
+        stack.clear();
+        stack.push_back(0);
+
+        while (!stack.empty()) {
+            const OctreeNode& node = nodes[stack.back()];
+            stack.pop_back();
+
+            if (node.mass == 0.0)
+                continue;
+
+            Vec3 r = node.centerOfMass - p;
             double dist = norm(r) + EPS;
-            double invDist3 = 1.0 / (dist * dist * dist);
 
-            // Newton's Law of Universal Gravitation: F = G * m1 * m2 / r^2
-            // Vector form: F_vec = F * (r_vec / r)
-            Vec3 force = r * (G * invDist3);
+            // Multipole Acceptance Criterion: far-away cells act as one mass.
+            // Leaves are always accepted (they ARE one mass), but a leaf
+            // holding the body itself must be skipped (no self-force).
+            bool isLeaf = (node.firstChild == -1);
+            if (isLeaf || (2.0 * node.halfSize) / dist < THETA) {
+                if (isLeaf && node.bodyIndex == static_cast<int>(bodyIdx))
+                    continue;
+
+                double invDist3 = 1.0 / (dist * dist * dist);
+                acc = acc + r * (G * node.mass * invDist3);
+            }
+            else {
+                for (int c = 0; c < 8; ++c)
+                    stack.push_back(node.firstChild + c);
+            }
+        }
+
+        return acc;
+    }
+
+private:
+    std::vector<OctreeNode> nodes;
+
+    // Octant selection: bit 0 = +x, bit 1 = +y, bit 2 = +z
+    static int octantOf(const Vec3& center, const Vec3& p) {
+        return (p.x >= center.x ? 1 : 0)
+            | (p.y >= center.y ? 2 : 0)
+            | (p.z >= center.z ? 4 : 0);
+    }
+
+    void subdivide(int nodeIdx) {
+        int first = static_cast<int>(nodes.size());
+        Vec3 c = nodes[nodeIdx].center;
+        double h = nodes[nodeIdx].halfSize * 0.5;
+
+        for (int o = 0; o < 8; ++o) {
+            OctreeNode child;
+            child.center = {
+                c.x + (o & 1 ? h : -h),
+                c.y + (o & 2 ? h : -h),
+                c.z + (o & 4 ? h : -h)
+            };
+            child.halfSize = h;
+            nodes.push_back(child);
+        }
+
+        nodes[nodeIdx].firstChild = first;
+    }
+
+    void insert(int nodeIdx, int bodyIdx, const PhysicsState& s) {
+        // Iterative descent; indices (not references) survive vector growth.
+        while (true) {
+            // Degenerate case: (near-)coincident bodies would subdivide
+            // forever. Drop the duplicate from the tree; the pair force at
+            // zero separation is meaningless anyway.
+            if (nodes[nodeIdx].halfSize < 1e-12)
+                return;
+
+            if (nodes[nodeIdx].firstChild == -1) {
+                if (nodes[nodeIdx].bodyIndex == -1) {
+                    nodes[nodeIdx].bodyIndex = bodyIdx;
+                    return;
+                }
+
+                // Occupied leaf: split it and push the resident body down
+                int resident = nodes[nodeIdx].bodyIndex;
+                nodes[nodeIdx].bodyIndex = -1;
+                subdivide(nodeIdx);
+
+                int residentOctant = octantOf(nodes[nodeIdx].center, s.position(resident));
+                nodes[nodes[nodeIdx].firstChild + residentOctant].bodyIndex = resident;
+            }
+
+            nodeIdx = nodes[nodeIdx].firstChild
+                + octantOf(nodes[nodeIdx].center, s.position(bodyIdx));
+        }
+    }
+
+    // Bottom-up pass computing total mass and center of mass per cell
+    void computeMassDistribution(int nodeIdx, const PhysicsState& s) {
+        OctreeNode& node = nodes[nodeIdx];
+
+        if (node.firstChild == -1) {
+            if (node.bodyIndex >= 0) {
+                node.mass = s.mass[node.bodyIndex];
+                node.centerOfMass = s.position(node.bodyIndex);
+            }
+            return;
+        }
 
-            // Apply forces (Action-Reaction pair)
-            bodies[i].acceleration =
-                bodies[i].acceleration + bodies[j].mass * force;
+        node.mass = 0.0;
+        node.centerOfMass = { 0,0,0 };
 
-            bodies[j].acceleration =
-                bodies[j].acceleration - bodies[i].mass * force;
+        for (int c = 0; c < 8; ++c) {
+            int child = node.firstChild + c;
+            computeMassDistribution(child, s);
+            node.mass += nodes[child].mass;
+            node.centerOfMass = node.centerOfMass
+                + nodes[child].centerOfMass * nodes[child].mass;
         }
+
+        if (node.mass > 0.0)
+            node.centerOfMass = node.centerOfMass / node.mass;
     }
+};
+
+void computeAccelerationsBarnesHut(PhysicsState& s) {
+    PROF_ZONE("accel.barnesHut");
+    static Octree tree;
+    tree.build(s);
+
+    // Tree traversal only reads shared state and each body writes its own
+    // slot, so this loop parallelizes without per-thread buffers.
+    ThreadPool::instance().run(s.count(), 256,
+        [&](size_t, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                Vec3 a = tree.accelerationOn(i, s);
+                s.accX[i] = a.x;
+                s.accY[i] = a.y;
+                s.accZ[i] = a.z;
+            }
+        });
+}
+
+// Force stage dispatcher. Auto picks exact pairwise for small scenes
+// and Barnes-Hut for large ones; --engine forces one path, which is
+// how the tiled parallel direct sum gets run at sizes Auto would hand
+// to the tree.
+enum class ForceEngine { Auto, Direct, BarnesHut };
+ForceEngine gForceEngine = ForceEngine::Auto;
+
+void computeAccelerations(PhysicsState& s) {
+    bool useBarnesHut = gForceEngine == ForceEngine::Auto
+        ? s.count() >= BARNES_HUT_THRESHOLD
+        : gForceEngine == ForceEngine::BarnesHut;
+
+    if (useBarnesHut)
+        computeAccelerationsBarnesHut(s);
+    else
+        computeAccelerationsDirect(s);
 }
 
 // Velocity Verlet Integration
 // A symplectic integrator that conserves energy better than Euler integration.
 // Essential for orbital stability.
-void velocityVerlet(std::vector<Body>& bodies) {
-    static std::vector<Vec3> oldAcc;
-    oldAcc.resize(bodies.size());
+void velocityVerlet(PhysicsState& s) {
+    static std::vector<double> oldAccX, oldAccY, oldAccZ;
+    const size_t n = s.count();
+    oldAccX.resize(n); oldAccY.resize(n); oldAccZ.resize(n);
 
     // Step 1: Update Position and Half-Update Velocity
-    for (size_t i = 0; i < bodies.size(); ++i) {
-        oldAcc[i] = bodies[i].acceleration;
+    for (size_t i = 0; i < n; ++i) {
+        oldAccX[i] = s.accX[i];
+        oldAccY[i] = s.accY[i];
+        oldAccZ[i] = s.accZ[i];
 
-        bodies[i].position =
-            bodies[i].position +
-            bodies[i].velocity * dt +
-            bodies[i].acceleration * (0.5 * dt * dt);
+        s.posX[i] += s.velX[i] * dt + s.accX[i] * (0.5 * dt * dt);
+        s.posY[i] += s.velY[i] * dt + s.accY[i] * (0.5 * dt * dt);
+        s.posZ[i] += s.velZ[i] * dt + s.accZ[i] * (0.5 * dt * dt);
     }
 
     // Step 2: Compute new forces based on new positions
-    computeAccelerations(bodies);
+    computeAccelerations(s);
 
     // Step 3: Finish updating Velocity using average of old and new acceleration
-    for (size_t i = 0; i < bodies.size(); ++i) {
-        bodies[i].velocity =
-            bodies[i].velocity +
-            (oldAcc[i] + bodies[i].acceleration) * (0.5 * dt);
+    for (size_t i = 0; i < n; ++i) {
+        s.velX[i] += (oldAccX[i] + s.accX[i]) * (0.5 * dt);
+        s.velY[i] += (oldAccY[i] + s.accY[i]) * (0.5 * dt);
+        s.velZ[i] += (oldAccZ[i] + s.accZ[i]) * (0.5 * dt);
+    }
+}
+
+// Block-Timestep Integration
+// Bodies are binned into power-of-two timestep tiers by their local
+// acceleration: tier t advances with dt * 2^t. A tightly bound body
+// (Mercury) stays at the base step while a slow one (Neptune) integrates
+// up to 2^MAX_TIER times coarser, skipping force evaluations it doesn't
+// need. All tiers synchronize at the end of each cycle of 2^MAX_TIER base
+// steps, and tiers are reassigned at cycle boundaries.
+const int MAX_TIER = 6; // coarsest step = 64x the base dt
+
+// Tier criterion: the local dynamical timescale scales as 1/sqrt(|a|).
+// ETA is calibrated so the tightest solar-system orbit (Mercury) lands in
+// tier 0 at the base dt.
+const double TIER_ETA = 0.008;
+
+inline int tierFor(double ax, double ay, double az) {
+    double accMag = std::sqrt(ax * ax + ay * ay + az * az);
+    double dtRequired = TIER_ETA / std::sqrt(accMag + EPS);
+
+    int t = static_cast<int>(std::floor(std::log2(dtRequired / dt)));
+    return std::clamp(t, 0, MAX_TIER);
+}
+
+// Accelerations for the active subset only: each active body sums over all
+// bodies (no pair saving — the reaction partner may be inactive), while
+// inactive bodies keep their last-computed acceleration. The payoff is that
+// a mostly-coarse scene evaluates O(active * N) instead of O(N^2) per base
+// step.
+void computeAccelerationsActive(PhysicsState& s,
+    const std::vector<size_t>& active) {
+    const size_t n = s.count();
+
+    for (size_t idx : active) {
+        double ax = 0.0, ay = 0.0, az = 0.0;
+
+        for (size_t j = 0; j < n; ++j) {
+            if (j == idx)
+                continue;
+
+            double rx = s.posX[j] - s.posX[idx];
+            double ry = s.posY[j] - s.posY[idx];
+            double rz = s.posZ[j] - s.posZ[idx];
+
+            double dist = std::sqrt(rx * rx + ry * ry + rz * rz) + EPS;
+            double invDist3 = 1.0 / (dist * dist * dist);
+            double f = G * s.mass[j] * invDist3;
+
+            ax += f * rx;
+            ay += f * ry;
+            az += f * rz;
+        }
+
+        s.accX[idx] = ax;
+        s.accY[idx] = ay;
+        s.accZ[idx] = az;
+    }
+}
+
+// Advances one full synchronization cycle (2^MAX_TIER base steps).
+// Within the cycle, a body in tier t takes its Verlet step every 2^t base
+// steps with step size dt * 2^t; bodies in coarser tiers hold their last
+// state in between (their own timescale says nothing changes faster).
+void velocityVerletAdaptive(PhysicsState& s) {
+    const size_t n = s.count();
+
+    static std::vector<int> tier;
+    static std::vector<double> oldAccX, oldAccY, oldAccZ;
+    static std::vector<size_t> active;
+
+    tier.resize(n);
+    oldAccX.resize(n); oldAccY.resize(n); oldAccZ.resize(n);
+
+    // Tier assignment from current accelerations, frozen for the cycle
+    for (size_t i = 0; i < n; ++i)
+        tier[i] = tierFor(s.accX[i], s.accY[i], s.accZ[i]);
+
+    const int cycleSteps = 1 << MAX_TIER;
+
+    for (int step = 0; step < cycleSteps; ++step) {
+        active.clear();
+        for (size_t i = 0; i < n; ++i)
+            if (step % (1 << tier[i]) == 0)
+                active.push_back(i);
+
+        // Step 1: Update Position and remember old acceleration (per tier dt)
+        for (size_t idx : active) {
+            double h = dt * (1 << tier[idx]);
+
+            oldAccX[idx] = s.accX[idx];
+            oldAccY[idx] = s.accY[idx];
+            oldAccZ[idx] = s.accZ[idx];
+
+            s.posX[idx] += s.velX[idx] * h + s.accX[idx] * (0.5 * h * h);
+            s.posY[idx] += s.velY[idx] * h + s.accY[idx] * (0.5 * h * h);
+            s.posZ[idx] += s.velZ[idx] * h + s.accZ[idx] * (0.5 * h * h);
+        }
+
+        // Step 2: New forces at new positions, active bodies only
+        computeAccelerationsActive(s, active);
+
+        // Step 3: Finish velocity with the averaged acceleration
+        for (size_t idx : active) {
+            double h = dt * (1 << tier[idx]);
+
+            s.velX[idx] += (oldAccX[idx] + s.accX[idx]) * (0.5 * h);
+            s.velY[idx] += (oldAccY[idx] + s.accY[idx]) * (0.5 * h);
+            s.velZ[idx] += (oldAccZ[idx] + s.accZ[idx]) * (0.5 * h);
+        }
     }
 }
 
@@ -120,44 +809,636 @@ sf::Vector2f toScreen(const Vec3& p) {
     );
 }
 
-// Factory function to create planets with initial circular orbital velocity
-Body makePlanet(double mass, double radius, sf::Color color, float drawSize) {
-    Body b;
-
-    b.mass = mass;
-    b.position = { radius,0,0 };
-
+// Factory function to create planets with initial circular orbital velocity.
+// `visuals` may be null: headless runs carry no render state at all.
+void makePlanet(PhysicsState& s, std::vector<BodyVisual>* visuals,
+    double mass, double radius, sf::Color color, float drawSize) {
     // Vis-viva equation simplification for circular orbit: v = sqrt(GM/r)
     // Assumes orbiting a central body of mass 1.0 (The Sun)
     double v = std::sqrt(G / radius);
-    b.velocity = { 0,v,0 };
 
-    b.shape = sf::CircleShape(drawSize);
-    b.shape.setFillColor(color);
-    b.shape.setOrigin({ drawSize, drawSize });
+    s.add(mass, { radius,0,0 }, { 0,v,0 });
 
-    return b;
+    if (visuals) {
+        BodyVisual vis;
+        vis.shape = sf::CircleShape(drawSize);
+        vis.shape.setFillColor(color);
+        vis.shape.setOrigin({ drawSize, drawSize });
+        visuals->push_back(vis);
+    }
 }
 
 // Corrects system momentum so the Solar System doesn't drift off-screen.
 // Centers the simulation on the Barycenter (Center of Mass).
-void enforceBarycenter(std::vector<Body>& bodies)
+void enforceBarycenter(PhysicsState& s)
 {
     Vec3 totalMomentum{ 0,0,0 };
     double totalMass = 0.0;
 
-    for (const auto& b : bodies) {
-        totalMomentum = totalMomentum + b.mass * b.velocity;
-        totalMass += b.mass;
+    for (size_t i = 0; i < s.count(); ++i) {
+        totalMomentum.x += s.mass[i] * s.velX[i];
+        totalMomentum.y += s.mass[i] * s.velY[i];
+        totalMomentum.z += s.mass[i] * s.velZ[i];
+        totalMass += s.mass[i];
     }
 
     Vec3 correction = totalMomentum / totalMass;
 
-    for (auto& b : bodies)
-        b.velocity = b.velocity - correction;
+    for (size_t i = 0; i < s.count(); ++i) {
+        s.velX[i] -= correction.x;
+        s.velY[i] -= correction.y;
+        s.velZ[i] -= correction.z;
+    }
+}
+
+// Loaded from --scenario; an empty body list means "use the built-in
+// Solar System below"
+scn::Scenario gScenario;
+
+// Scene setup shared by windowed and headless runs
+void buildSolarSystem(PhysicsState& state, std::vector<BodyVisual>* visuals)
+{
+    // The Sun
+    state.add(1.0, { 0,0,0 }, { 0,0,0 });
+
+    if (visuals) {
+        BodyVisual sunVis;
+        sunVis.shape = sf::CircleShape(4.f);
+        sunVis.shape.setFillColor(sf::Color::Yellow);
+        sunVis.shape.setOrigin({ 4.f,4.f });
+        visuals->push_back(sunVis);
+    }
+
+    if (!gScenario.bodies.empty()) {
+        // Scenario override: one planet per configured body
+        for (const scn::Body& b : gScenario.bodies)
+            makePlanet(state, visuals, b.mass, b.distanceAU,
+                sf::Color(b.r, b.g, b.b), b.drawSize);
+    }
+    else {
+        // Planets (Mass relative to Sun, Distance in AU)
+        makePlanet(state, visuals, 1.66e-7, 0.39, sf::Color(200, 200, 200), 1.f);  // Mercury
+        makePlanet(state, visuals, 2.45e-6, 0.72, sf::Color(255, 180, 120), 1.5f); // Venus
+        makePlanet(state, visuals, 3.00e-6, 1.00, sf::Color::Blue, 2.f);           // Earth
+        makePlanet(state, visuals, 3.23e-7, 1.52, sf::Color::Red, 1.5f);           // Mars
+        makePlanet(state, visuals, 9.54e-4, 5.20, sf::Color(210, 170, 120), 3.f);  // Jupiter
+        makePlanet(state, visuals, 2.86e-4, 9.58, sf::Color(220, 200, 150), 2.5f); // Saturn
+        makePlanet(state, visuals, 4.36e-5, 19.2, sf::Color::Cyan, 2.f);           // Uranus
+        makePlanet(state, visuals, 5.15e-5, 30.1, sf::Color(120, 120, 255), 2.f);  // Neptune
+    }
+
+    computeAccelerations(state);
+    enforceBarycenter(state); // Stabilize system momentum before starting
+}
+
+// Physics pacing: the integrator historically ran 5 substeps per 60 FPS
+// frame; the decoupled physics thread keeps the same 300 steps/second so
+// windowed behavior is unchanged, just no longer tied to render timing.
+const int PHYSICS_STEPS_PER_SECOND = 300;
+const int STEPS_PER_SNAPSHOT = 5; // publish at ~60 Hz, not every substep
+
+// Lock-free triple buffer carrying body position snapshots from the physics
+// thread to the render thread. The writer always has a free slot to fill and
+// the reader always has the freshest published slot, so neither side ever
+// blocks the other — a render hiccup can no longer stall integration.
+class SnapshotChannel {
+public:
+    void init(size_t bodies) {
+        for (auto& s : slots)
+            s.assign(bodies, Vec3{ 0,0,0 });
+    }
+
+    void publish(const PhysicsState& s) {
+        std::vector<Vec3>& back = slots[backIdx];
+        for (size_t i = 0; i < s.count(); ++i)
+            back[i] = s.position(i);
+
+        // Swap the filled slot into the middle, marking it fresh (bit 2)
+        backIdx = middle.exchange(backIdx | FRESH,
+            std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    // Returns the most recent snapshot; contents are stable until the next
+    // acquire() call on this (single) reader thread.
+    const std::vector<Vec3>& acquire() {
+        if (middle.load(std::memory_order_acquire) & FRESH)
+            frontIdx = middle.exchange(frontIdx,
+                std::memory_order_acq_rel) & INDEX_MASK;
+        return slots[frontIdx];
+    }
+
+private:
+    static const int FRESH = 4;
+    static const int INDEX_MASK = 3;
+
+    std::vector<Vec3> slots[3];
+    int backIdx = 0;                 // owned by the physics thread
+    int frontIdx = 1;                // owned by the render thread
+    std::atomic<int> middle{ 2 };    // hand-off slot + freshness flag
+};
+
+// On-disk trajectory format (binary, little-endian):
+//   TrajectoryHeader
+//   bodyCount doubles   — masses (static over a run)
+//   frames              — bodyCount * 6 doubles each (pos x/y/z, vel x/y/z)
+// The frame count is derived from the file size, so a crash mid-write costs
+// at most the trailing partial frame; everything before it stays a valid
+// checkpoint to resume from, and the writer trims that partial frame off
+// before appending when a run resumes into the same file.
+#pragma pack(push, 1)
+struct TrajectoryHeader {
+    char magic[4];          // "NBTJ"
+    std::uint32_t version;
+    std::uint64_t bodyCount;
+    double timeStep;
+};
+#pragma pack(pop)
+
+const std::uint32_t TRAJECTORY_VERSION = 1;
+const size_t TRAJECTORY_FLUSH_BYTES = 4u << 20; // write in 4 MB chunks
+const long long CHECKPOINT_INTERVAL = 100;      // steps between frames
+
+const size_t DOUBLES_PER_BODY_FRAME = 6;
+
+// Streams trajectory frames to disk through a large in-memory buffer so the
+// integrator never blocks on small writes.
+class TrajectoryWriter {
+public:
+    bool open(const std::string& path, const PhysicsState& s, bool append) {
+        // A crash mid-write can leave a partial frame at the tail;
+        // appending after it would misalign every frame that follows,
+        // so resume trims back to the last complete frame first
+        if (append && !truncatePartialFrame(path, s.count()))
+            return false;
+
+        auto mode = std::ios::binary | (append ? std::ios::app : std::ios::trunc);
+        file.open(path, mode);
+        if (!file)
+            return false;
+
+        if (!append) {
+            TrajectoryHeader h;
+            std::memcpy(h.magic, "NBTJ", 4);
+            h.version = TRAJECTORY_VERSION;
+            h.bodyCount = s.count();
+            h.timeStep = dt;
+            file.write(reinterpret_cast<const char*>(&h), sizeof(h));
+            file.write(reinterpret_cast<const char*>(s.mass.data()),
+                s.count() * sizeof(double));
+        }
+
+        buffer.reserve(TRAJECTORY_FLUSH_BYTES
+            + s.count() * DOUBLES_PER_BODY_FRAME * sizeof(double));
+        return file.good();
+    }
+
+    void writeFrame(const PhysicsState& s) {
+        for (size_t i = 0; i < s.count(); ++i) {
+            double v[DOUBLES_PER_BODY_FRAME] = {
+                s.posX[i], s.posY[i], s.posZ[i],
+                s.velX[i], s.velY[i], s.velZ[i]
+            };
+            const char* p = reinterpret_cast<const char*>(v);
+            buffer.insert(buffer.end(), p, p + sizeof(v));
+        }
+
+        if (buffer.size() >= TRAJECTORY_FLUSH_BYTES)
+            flush();
+    }
+
+    void flush() {
+        if (!buffer.empty()) {
+            file.write(buffer.data(), buffer.size());
+            buffer.clear();
+        }
+    }
+
+    ~TrajectoryWriter() { flush(); }
+
+private:
+    // Cuts the file back to a whole number of frames. Fails when the
+    // file is shorter than its own header — nothing valid to resume
+    // into — which makes open() refuse rather than write garbage.
+    static bool truncatePartialFrame(const std::string& path, size_t bodyCount) {
+        std::error_code ec;
+        std::uintmax_t size = std::filesystem::file_size(path, ec);
+        if (ec)
+            return false;
+
+        const std::uintmax_t prefix =
+            sizeof(TrajectoryHeader) + bodyCount * sizeof(double);
+        const std::uintmax_t frameBytes =
+            bodyCount * DOUBLES_PER_BODY_FRAME * sizeof(double);
+        if (size < prefix)
+            return false;
+
+        std::uintmax_t partial = (size - prefix) % frameBytes;
+        if (partial)
+            std::filesystem::resize_file(path, size - partial, ec);
+        return !ec;
+    }
+
+    std::ofstream file;
+    std::vector<char> buffer;
+};
+
+// Memory-mapped trajectory access: the OS pages frames in on demand, so a
+// 10 GB file can be scrubbed without loading it into RAM.
+class TrajectoryReader {
+public:
+    bool open(const std::string& path) {
+#if defined(_WIN32)
+        fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+            nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (fileHandle == INVALID_HANDLE_VALUE)
+            return false;
+
+        LARGE_INTEGER sz;
+        GetFileSizeEx(fileHandle, &sz);
+        mappedSize = static_cast<size_t>(sz.QuadPart);
+
+        mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY,
+            0, 0, nullptr);
+        if (!mappingHandle)
+            return false;
+
+        base = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+
+        struct stat st;
+        fstat(fd, &st);
+        mappedSize = static_cast<size_t>(st.st_size);
+
+        base = mmap(nullptr, mappedSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd); // the mapping keeps its own reference
+        if (base == MAP_FAILED) {
+            base = nullptr;
+            return false;
+        }
+#endif
+        if (!base || mappedSize < sizeof(TrajectoryHeader))
+            return false;
+
+        const auto* h = static_cast<const TrajectoryHeader*>(base);
+        if (std::memcmp(h->magic, "NBTJ", 4) != 0
+            || h->version != TRAJECTORY_VERSION)
+            return false;
+
+        bodies = static_cast<size_t>(h->bodyCount);
+        frameBytes = bodies * DOUBLES_PER_BODY_FRAME * sizeof(double);
+        dataOffset = sizeof(TrajectoryHeader) + bodies * sizeof(double);
+        return mappedSize >= dataOffset;
+    }
+
+    size_t bodyCount() const { return bodies; }
+
+    // Partial trailing frames (crash mid-write) are excluded
+    size_t frameCount() const {
+        return (mappedSize - dataOffset) / frameBytes;
+    }
+
+    const double* masses() const {
+        return reinterpret_cast<const double*>(
+            static_cast<const char*>(base) + sizeof(TrajectoryHeader));
+    }
+
+    const double* frame(size_t f) const {
+        return reinterpret_cast<const double*>(
+            static_cast<const char*>(base) + dataOffset + f * frameBytes);
+    }
+
+    ~TrajectoryReader() {
+#if defined(_WIN32)
+        if (base) UnmapViewOfFile(base);
+        if (mappingHandle) CloseHandle(mappingHandle);
+        if (fileHandle != INVALID_HANDLE_VALUE) CloseHandle(fileHandle);
+#else
+        if (base) munmap(base, mappedSize);
+#endif
+    }
+
+private:
+    void* base = nullptr;
+    size_t mappedSize = 0;
+    size_t bodies = 0;
+    size_t frameBytes = 0;
+    size_t dataOffset = 0;
+#if defined(_WIN32)
+    HANDLE fileHandle = INVALID_HANDLE_VALUE;
+    HANDLE mappingHandle = nullptr;
+#endif
+};
+
+// Rebuilds physics state from the last complete frame of a trajectory
+bool resumeFromTrajectory(const std::string& path, PhysicsState& state)
+{
+    TrajectoryReader reader;
+    if (!reader.open(path) || reader.frameCount() == 0)
+        return false;
+
+    const double* m = reader.masses();
+    const double* f = reader.frame(reader.frameCount() - 1);
+
+    for (size_t i = 0; i < reader.bodyCount(); ++i) {
+        state.add(m[i],
+            { f[i * 6 + 0], f[i * 6 + 1], f[i * 6 + 2] },
+            { f[i * 6 + 3], f[i * 6 + 4], f[i * 6 + 5] });
+    }
+
+    computeAccelerations(state);
+    return true;
+}
+
+// Replay summary: demonstrates scrubbing a mapped trajectory without
+// loading it — only the touched frames are paged in.
+int runReplay(const std::string& path)
+{
+    TrajectoryReader reader;
+    if (!reader.open(path)) {
+        std::cerr << "Cannot open trajectory: " << path << "\n";
+        return 1;
+    }
+
+    size_t frames = reader.frameCount();
+    std::cout << "Trajectory: " << reader.bodyCount() << " bodies, "
+        << frames << " frames, "
+        << frames * CHECKPOINT_INTERVAL * dt << " years\n";
+
+    if (frames > 0) {
+        const double* first = reader.frame(0);
+        const double* last = reader.frame(frames - 1);
+        std::cout << "Body 0 start: (" << first[0] << ", " << first[1]
+            << ", " << first[2] << ")\n";
+        std::cout << "Body 0 end:   (" << last[0] << ", " << last[1]
+            << ", " << last[2] << ")\n";
+    }
+
+    return 0;
+}
+
+// Benchmark & Regression Suite
+// Runs the integrator headless over generated scenes of increasing size,
+// reporting raw throughput, and checks that the symplectic property holds:
+// relative energy drift over a fixed step count must stay within tolerance.
+// Any optimization to computeAccelerations()/velocityVerlet() should keep
+// this green before it ships.
+// The exact direct-sum engine is held to a tighter bound than Barnes-Hut,
+// whose theta-dependent force approximation is not energy-conserving. Both
+// bounds are set by the densest disk the check runs on — 1000 bodies
+// drifts ~1.3e-3 at the fixed timestep from close encounters alone,
+// whichever engine computes the forces — while a broken force kernel
+// overshoots them by orders of magnitude.
+const double DRIFT_TOLERANCE_DIRECT = 5e-3;
+const double DRIFT_TOLERANCE_BARNES_HUT = 1e-2;
+const long long DRIFT_CHECK_STEPS = 1000;
+
+// Energy checks are O(N^2) in the potential term; cap the body count they
+// run at so the suite stays fast (throughput is still measured above it).
+const size_t DRIFT_CHECK_MAX_BODIES = 5000;
+
+// Total mechanical energy: kinetic + pairwise gravitational potential
+double totalEnergy(const PhysicsState& s) {
+    const size_t n = s.count();
+    double e = 0.0;
+
+    for (size_t i = 0; i < n; ++i) {
+        double v2 = s.velX[i] * s.velX[i]
+            + s.velY[i] * s.velY[i]
+            + s.velZ[i] * s.velZ[i];
+        e += 0.5 * s.mass[i] * v2;
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = i + 1; j < n; ++j) {
+            double rx = s.posX[j] - s.posX[i];
+            double ry = s.posY[j] - s.posY[i];
+            double rz = s.posZ[j] - s.posZ[i];
+            double dist = std::sqrt(rx * rx + ry * ry + rz * rz) + EPS;
+            e -= G * s.mass[i] * s.mass[j] / dist;
+        }
+    }
+
+    return e;
+}
+
+// Disk distribution: central solar mass plus n-1 light bodies on circular
+// orbits (log-uniform radii). Dynamically calm — the scene used for the
+// energy-drift check.
+void makeDisk(PhysicsState& s, size_t n, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> angle(0.0, 2.0 * M_PI);
+    std::uniform_real_distribution<double> logR(std::log(0.4), std::log(30.0));
+
+    s.add(1.0, { 0,0,0 }, { 0,0,0 });
+
+    for (size_t i = 1; i < n; ++i) {
+        double r = std::exp(logR(rng));
+        double a = angle(rng);
+        double v = std::sqrt(G / r);
+
+        s.add(1e-6,
+            { r * std::cos(a), r * std::sin(a), 0.0 },
+            { -v * std::sin(a), v * std::cos(a), 0.0 });
+    }
+
+    computeAccelerations(s);
+}
+
+// Cluster distribution: equal-mass bodies in a uniform ball with random
+// sub-virial velocities. Collapsing and collision-rich — the stress scene
+// for throughput measurement.
+void makeCluster(PhysicsState& s, size_t n, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> unit(-1.0, 1.0);
+
+    double bodyMass = 1.0 / static_cast<double>(n);
+
+    for (size_t i = 0; i < n; ++i) {
+        // Rejection-sample the unit ball, then scale to a 5 AU radius
+        Vec3 p;
+        do {
+            p = { unit(rng), unit(rng), unit(rng) };
+        } while (p.x * p.x + p.y * p.y + p.z * p.z > 1.0);
+
+        s.add(bodyMass, p * 5.0,
+            { unit(rng) * 0.5, unit(rng) * 0.5, unit(rng) * 0.5 });
+    }
+
+    computeAccelerations(s);
 }
 
-int main()
+// Direct sum is O(n^2); above this body count a single case takes
+// minutes, and the tiled parallel path is already well exercised
+const size_t DIRECT_BENCH_MAX_BODIES = 10000;
+
+int runBenchmark(long long stepsPerCase)
+{
+    const size_t bodyCounts[] = { 10, 100, 1000, 10000, 100000 };
+    bool allPassed = true;
+
+    std::cout << "bodies  scene    engine      steps/s      ns/pair   drift\n";
+
+    // Each engine is forced in turn rather than letting the dispatcher
+    // choose, so the parallel direct sum and the Barnes-Hut tree are
+    // both measured and drift-checked at every size they can handle.
+    for (size_t n : bodyCounts) {
+        for (int scene = 0; scene < 2; ++scene) {
+          for (int e = 0; e < 2; ++e) {
+            gForceEngine = e == 0 ? ForceEngine::Direct
+                                  : ForceEngine::BarnesHut;
+            if (gForceEngine == ForceEngine::Direct &&
+                n > DIRECT_BENCH_MAX_BODIES)
+                continue;
+
+            PhysicsState state;
+            if (scene == 0)
+                makeDisk(state, n, 12345);
+            else
+                makeCluster(state, n, 12345);
+
+            const char* engine = e == 0 ? "direct" : "barnes-hut";
+
+            // Throughput measurement
+            auto start = std::chrono::steady_clock::now();
+            for (long long i = 0; i < stepsPerCase; ++i)
+                velocityVerlet(state);
+            std::chrono::duration<double> elapsed =
+                std::chrono::steady_clock::now() - start;
+
+            double stepsPerSec = stepsPerCase / elapsed.count();
+            double pairs = 0.5 * n * (n - 1.0);
+            double nsPerPair =
+                elapsed.count() * 1e9 / (stepsPerCase * pairs);
+
+            // Energy-drift regression (disk scene only: it is dynamically
+            // calm, so drift there measures integrator error, not physics)
+            std::string driftCol = "-";
+            if (scene == 0 && n <= DRIFT_CHECK_MAX_BODIES) {
+                PhysicsState drift;
+                makeDisk(drift, n, 12345);
+
+                double e0 = totalEnergy(drift);
+                for (long long i = 0; i < DRIFT_CHECK_STEPS; ++i)
+                    velocityVerlet(drift);
+                double e1 = totalEnergy(drift);
+
+                double rel = std::abs((e1 - e0) / e0);
+                double tolerance = e == 1
+                    ? DRIFT_TOLERANCE_BARNES_HUT
+                    : DRIFT_TOLERANCE_DIRECT;
+                bool ok = rel <= tolerance;
+                allPassed = allPassed && ok;
+
+                char buf[64];
+                std::snprintf(buf, sizeof(buf), "%.2e %s",
+                    rel, ok ? "PASS" : "FAIL");
+                driftCol = buf;
+            }
+
+            char line[160];
+            std::snprintf(line, sizeof(line),
+                "%-7zu %-8s %-10s %11.1f %12.4f   %s",
+                n, scene == 0 ? "disk" : "cluster", engine,
+                stepsPerSec, nsPerPair, driftCol.c_str());
+            std::cout << line << "\n";
+          }
+        }
+    }
+
+    gForceEngine = ForceEngine::Auto;
+
+    std::cout << (allPassed
+        ? "\nAll energy-drift checks passed.\n"
+        : "\nEnergy-drift check FAILED.\n");
+    return allPassed ? 0 : 1;
+}
+
+// Headless mode: no window, no pacing — the integrator runs flat-out for a
+// fixed number of steps. Used for batch orbit-stability studies.
+// Optionally records checkpoints to a trajectory file and/or resumes from
+// the last checkpoint of a previous (possibly crashed) run.
+int runHeadless(long long steps, const std::string& recordPath,
+    const std::string& resumePath, bool adaptive)
+{
+    PhysicsState state;
+
+    if (!resumePath.empty()) {
+        if (!resumeFromTrajectory(resumePath, state)) {
+            std::cerr << "Cannot resume from: " << resumePath << "\n";
+            return 1;
+        }
+        std::cout << "Resumed " << state.count() << " bodies from "
+            << resumePath << "\n";
+    }
+    else {
+        buildSolarSystem(state, nullptr);
+    }
+
+    TrajectoryWriter writer;
+    bool recording = false;
+    if (!recordPath.empty()) {
+        // Resuming into the same file appends; anything else starts fresh
+        recording = writer.open(recordPath, state, recordPath == resumePath);
+        if (!recording) {
+            std::cerr << "Cannot open trajectory for writing: "
+                << recordPath << "\n";
+            return 1;
+        }
+    }
+
+    std::cout << "Headless run: " << state.count() << " bodies, "
+        << steps << " steps"
+        << (adaptive ? " (adaptive block timesteps)" : "") << "\n";
+
+    auto start = std::chrono::steady_clock::now();
+
+    if (adaptive) {
+        // Advance in whole synchronization cycles; checkpoint whenever a
+        // cycle crosses a checkpoint boundary (cycles and the interval
+        // need not divide evenly).
+        const long long cycle = 1LL << MAX_TIER;
+        long long nextCheckpoint = CHECKPOINT_INTERVAL;
+
+        for (long long i = 0; i < steps; i += cycle) {
+            velocityVerletAdaptive(state);
+
+            if (recording && i + cycle >= nextCheckpoint) {
+                writer.writeFrame(state);
+                nextCheckpoint += CHECKPOINT_INTERVAL;
+            }
+        }
+    }
+    else {
+        for (long long i = 1; i <= steps; ++i) {
+            velocityVerlet(state);
+
+            if (recording && i % CHECKPOINT_INTERVAL == 0)
+                writer.writeFrame(state);
+        }
+    }
+
+    writer.flush();
+
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+
+    std::cout << "Simulated " << steps * dt << " years in "
+        << elapsed.count() << " s ("
+        << static_cast<long long>(steps / elapsed.count())
+        << " steps/s)\n";
+
+    if (prof::enabled()) {
+        prof::dump("nbody_profile.csv");
+        std::cout << prof::overlayText();
+    }
+
+    return 0;
+}
+
+int runWindowed()
 {
     auto desktop = sf::VideoMode::getDesktopMode();
 
@@ -184,90 +1465,177 @@ int main()
     window.setFramerateLimit(60);
 
     // Simulation Setup
-    std::vector<Body> bodies;
-
-    // The Sun
-    Body sun;
-    sun.mass = 1.0;
-    sun.position = { 0,0,0 };
-    sun.velocity = { 0,0,0 };
-    sun.shape = sf::CircleShape(4.f);
-    sun.shape.setFillColor(sf::Color::Yellow);
-    sun.shape.setOrigin({ 4.f,4.f });
-
-    bodies.push_back(sun);
-
-    // Planets (Mass relative to Sun, Distance in AU)
-    bodies.push_back(makePlanet(1.66e-7, 0.39, sf::Color(200, 200, 200), 1.f)); // Mercury
-    bodies.push_back(makePlanet(2.45e-6, 0.72, sf::Color(255, 180, 120), 1.5f)); // Venus
-    bodies.push_back(makePlanet(3.00e-6, 1.00, sf::Color::Blue, 2.f));           // Earth
-    bodies.push_back(makePlanet(3.23e-7, 1.52, sf::Color::Red, 1.5f));            // Mars
-    bodies.push_back(makePlanet(9.54e-4, 5.20, sf::Color(210, 170, 120), 3.f));   // Jupiter
-    bodies.push_back(makePlanet(2.86e-4, 9.58, sf::Color(220, 200, 150), 2.5f));  // Saturn
-    bodies.push_back(makePlanet(4.36e-5, 19.2, sf::Color::Cyan, 2.f));            // Uranus
-    bodies.push_back(makePlanet(5.15e-5, 30.1, sf::Color(120, 120, 255), 2.f));   // Neptune
-
-    computeAccelerations(bodies);
-    enforceBarycenter(bodies); // Stabilize system momentum before starting
+    PhysicsState state;
+    std::vector<BodyVisual> visuals;
+    buildSolarSystem(state, &visuals);
 
     const size_t MAX_TRAIL = 1500;
 
+    TrailRenderer trails;
+    trails.init(state.count(), MAX_TRAIL);
+    for (size_t i = 0; i < state.count(); ++i)
+        trails.setColor(i, visuals[i].shape.getFillColor());
+
+    SnapshotChannel channel;
+    channel.init(state.count());
+    channel.publish(state); // seed so the first frame has valid positions
+
+    // Physics thread: integrates at a fixed step rate, publishing snapshots.
+    // Pacing uses absolute deadlines so a late batch catches up instead of
+    // permanently slowing down.
+    std::atomic<bool> running{ true };
+    std::thread physicsThread([&] {
+        using clock = std::chrono::steady_clock;
+        const auto stepPeriod =
+            std::chrono::duration_cast<clock::duration>(
+                std::chrono::duration<double>(1.0 / PHYSICS_STEPS_PER_SECOND));
+
+        auto nextDeadline = clock::now();
+
+        while (running.load(std::memory_order_relaxed)) {
+            {
+                PROF_ZONE("physics.batch");
+                for (int i = 0; i < STEPS_PER_SNAPSHOT; ++i)
+                    velocityVerlet(state);
+            }
+
+            channel.publish(state);
+
+            nextDeadline += stepPeriod * STEPS_PER_SNAPSHOT;
+            std::this_thread::sleep_until(nextDeadline);
+        }
+        });
+
+    // Timing overlay (F3); this app ships no font, so without one the
+    // stats fall back to the console instead of vanishing
+    sf::Font overlayFont;
+    bool haveFont = overlayFont.openFromFile("arial.ttf");
+    sf::Text overlay(overlayFont);
+    overlay.setCharacterSize(14);
+    overlay.setFillColor(sf::Color::Green);
+    overlay.setPosition({ 16.f, 16.f });
+
     while (window.isOpen())
     {
         while (const std::optional event = window.pollEvent())
         {
             if (event->is<sf::Event::Closed>())
                 window.close();
+
+            if (event->is<sf::Event::KeyPressed>() &&
+                event->getIf<sf::Event::KeyPressed>()->code == sf::Keyboard::Key::F3) {
+                bool on = !prof::enabled();
+                prof::setEnabled(on);
+                if (!haveFont) {
+                    if (on)
+                        std::cout << "Profiling on (no arial.ttf for the "
+                            "overlay; stats print here on toggle off)\n";
+                    else
+                        std::cout << prof::overlayText();
+                }
+            }
         }
 
-        // Sub-stepping: Perform 5 physics updates per frame for smoother orbits
-        for (int i = 0; i < 5; ++i)
-            velocityVerlet(bodies);
+        PROF_ZONE("frame.render");
 
-        // Trail Management
-        for (auto& b : bodies)
-        {
-            b.trail.push_back(toScreen(b.position));
-            if (b.trail.size() > MAX_TRAIL)
-                b.trail.pop_front();
-        }
+        // Latest physics snapshot; render never touches live physics state
+        const std::vector<Vec3>& positions = channel.acquire();
 
-        window.clear(sf::Color::Black);
+        // Trail Management: one ring-buffer write per body
+        for (size_t i = 0; i < positions.size(); ++i)
+            trails.push(i, toScreen(positions[i]));
 
-        // Render Trails
-        for (auto& b : bodies)
-        {
-            if (b.trail.size() > 1)
-            {
-                // Create a vertex array for the trail
-                sf::VertexArray trail(sf::PrimitiveType::LineStrip, b.trail.size());
-
-                for (size_t i = 0; i < b.trail.size(); ++i)
-                {
-                    // Calculate alpha fade based on index (older points = more transparent)
-                    float alpha = static_cast<float>(i) / b.trail.size();
-                    trail[i].position = b.trail[i];
-                    trail[i].color = sf::Color(
-                        b.shape.getFillColor().r,
-                        b.shape.getFillColor().g,
-                        b.shape.getFillColor().b,
-                        static_cast<std::uint8_t>(alpha * 255)
-                    );
-                }
+        window.clear(sf::Color::Black);
 
-                window.draw(trail);
-            }
-        }
+        // Render Trails: all bodies in a single batched draw call
+        trails.draw(window);
 
         // Render Bodies
-        for (auto& b : bodies)
+        for (size_t i = 0; i < positions.size(); ++i)
         {
-            b.shape.setPosition(toScreen(b.position));
-            window.draw(b.shape);
+            visuals[i].shape.setPosition(toScreen(positions[i]));
+            window.draw(visuals[i].shape);
+        }
+
+        if (prof::enabled() && haveFont) {
+            overlay.setString(prof::overlayText());
+            window.draw(overlay);
         }
 
         window.display();
     }
 
+    running.store(false);
+    physicsThread.join();
+
+    if (prof::enabled())
+        prof::dump("nbody_profile.csv");
+
     return 0;
 }
+
+int main(int argc, char* argv[])
+{
+    // Usage: NBodySimulation [--headless [steps]] [--adaptive]
+    //                        [--record <file>] [--resume <file>]
+    //                        [--replay <file>] [--bench [steps]] [--profile]
+    //                        [--scenario <file>] [--engine direct|bh]
+    // (--profile, --scenario and --engine must precede --replay/--bench,
+    // which return immediately; --bench forces both engines in turn)
+    bool headless = false;
+    bool adaptive = false;
+    long long steps = 1000000;
+    std::string recordPath, resumePath;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+
+        if (arg == "--headless") {
+            headless = true;
+            if (i + 1 < argc && argv[i + 1][0] != '-')
+                steps = std::atoll(argv[++i]);
+        }
+        else if (arg == "--adaptive") {
+            adaptive = true;
+        }
+        else if (arg == "--record" && i + 1 < argc) {
+            recordPath = argv[++i];
+        }
+        else if (arg == "--resume" && i + 1 < argc) {
+            resumePath = argv[++i];
+        }
+        else if (arg == "--replay" && i + 1 < argc) {
+            return runReplay(argv[++i]);
+        }
+        else if (arg == "--bench") {
+            long long benchSteps = 100;
+            if (i + 1 < argc && argv[i + 1][0] != '-')
+                benchSteps = std::atoll(argv[++i]);
+            return runBenchmark(benchSteps);
+        }
+        else if (arg == "--profile") {
+            prof::setEnabled(true);
+        }
+        else if (arg == "--scenario" && i + 1 < argc) {
+            std::string err;
+            if (!scn::load(argv[++i], gScenario, err)) {
+                std::cerr << err << "\n";
+                return 1;
+            }
+        }
+        else if (arg == "--engine" && i + 1 < argc) {
+            std::string engine = argv[++i];
+            if (engine == "direct") gForceEngine = ForceEngine::Direct;
+            else if (engine == "bh") gForceEngine = ForceEngine::BarnesHut;
+            else {
+                std::cerr << "Unknown engine: " << engine << " (direct|bh)\n";
+                return 1;
+            }
+        }
+    }
+
+    if (headless)
+        return runHeadless(steps, recordPath, resumePath, adaptive);
+
+    return runWindowed();
+}